@@ -0,0 +1,441 @@
+#include <osg/GL>
+#include <osg/GLExtensions>
+#include <osg/GraphicsContext>
+#include <osg/ref_ptr>
+
+#include <osgViewer/Version>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER 0x8D40
+#endif
+#ifndef GL_READ_FRAMEBUFFER
+#define GL_READ_FRAMEBUFFER 0x8CA8
+#endif
+#ifndef GL_DRAW_FRAMEBUFFER
+#define GL_DRAW_FRAMEBUFFER 0x8CA9
+#endif
+#ifndef GL_COLOR_ATTACHMENT0
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#endif
+#ifndef GL_DEPTH_STENCIL_ATTACHMENT
+#define GL_DEPTH_STENCIL_ATTACHMENT 0x821A
+#endif
+#ifndef GL_FRAMEBUFFER_COMPLETE
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#endif
+#ifndef GL_TEXTURE_2D_MULTISAMPLE
+#define GL_TEXTURE_2D_MULTISAMPLE 0x9100
+#endif
+#ifndef GL_DEPTH_STENCIL
+#define GL_DEPTH_STENCIL 0x84F9
+#endif
+#ifndef GL_DEPTH32F_STENCIL8
+#define GL_DEPTH32F_STENCIL8 0x8CAD
+#endif
+#ifndef GL_FLOAT_32_UNSIGNED_INT_24_8_REV
+#define GL_FLOAT_32_UNSIGNED_INT_24_8_REV 0x8DAD
+#endif
+
+namespace
+{
+
+// the render targets of a view: a multisample color and depth
+// stencil target that is resolved to a single sample color buffer
+constexpr GLsizei SAMPLES { 8 };
+
+constexpr uint32_t STEADY_WIDTH { 1920 };
+constexpr uint32_t STEADY_HEIGHT { 1080 };
+// a window edge dragged a few pixels every frame
+constexpr uint32_t RESIZE_STEP { 8 };
+constexpr uint32_t RESIZE_STEPS { 64 };
+
+constexpr size_t WARMUP_FRAMES { 32 };
+constexpr size_t FRAMES { 512 };
+
+struct GLFunctions
+{
+   void (GL_APIENTRY * glGenFramebuffers)( GLsizei, GLuint * ) { nullptr };
+   void (GL_APIENTRY * glDeleteFramebuffers)( GLsizei, const GLuint * ) { nullptr };
+   void (GL_APIENTRY * glBindFramebuffer)( GLenum, GLuint ) { nullptr };
+   void (GL_APIENTRY * glFramebufferTexture2D)( GLenum, GLenum, GLenum, GLuint, GLint ) { nullptr };
+   GLenum (GL_APIENTRY * glCheckFramebufferStatus)( GLenum ) { nullptr };
+   void (GL_APIENTRY * glBlitFramebuffer)( GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLbitfield, GLenum ) { nullptr };
+   void (GL_APIENTRY * glTexImage2DMultisample)( GLenum, GLsizei, GLenum, GLsizei, GLsizei, GLboolean ) { nullptr };
+   void (GL_APIENTRY * glTexStorage2D)( GLenum, GLsizei, GLenum, GLsizei, GLsizei ) { nullptr };
+   void (GL_APIENTRY * glTexStorage2DMultisample)( GLenum, GLsizei, GLenum, GLsizei, GLsizei, GLboolean ) { nullptr };
+
+   bool Load( )
+   {
+      return
+         osg::setGLExtensionFuncPtr(glGenFramebuffers, "glGenFramebuffers") &&
+         osg::setGLExtensionFuncPtr(glDeleteFramebuffers, "glDeleteFramebuffers") &&
+         osg::setGLExtensionFuncPtr(glBindFramebuffer, "glBindFramebuffer") &&
+         osg::setGLExtensionFuncPtr(glFramebufferTexture2D, "glFramebufferTexture2D") &&
+         osg::setGLExtensionFuncPtr(glCheckFramebufferStatus, "glCheckFramebufferStatus") &&
+         osg::setGLExtensionFuncPtr(glBlitFramebuffer, "glBlitFramebuffer") &&
+         osg::setGLExtensionFuncPtr(glTexImage2DMultisample, "glTexImage2DMultisample") &&
+         osg::setGLExtensionFuncPtr(glTexStorage2D, "glTexStorage2D") &&
+         osg::setGLExtensionFuncPtr(glTexStorage2DMultisample, "glTexStorage2DMultisample");
+   }
+};
+
+GLFunctions gl_;
+
+class RenderTargets
+{
+public:
+   explicit RenderTargets(
+      const bool immutable_storage ) :
+   immutable_storage_ { immutable_storage }
+   {
+      gl_.glGenFramebuffers(1, &multisample_frame_buffer_);
+      gl_.glGenFramebuffers(1, &resolve_frame_buffer_);
+   }
+
+   ~RenderTargets( )
+   {
+      DeleteTextures();
+
+      gl_.glDeleteFramebuffers(1, &multisample_frame_buffer_);
+      gl_.glDeleteFramebuffers(1, &resolve_frame_buffer_);
+   }
+
+   RenderTargets( const RenderTargets & ) = delete;
+   RenderTargets & operator = ( const RenderTargets & ) = delete;
+
+   bool Resize(
+      const uint32_t width,
+      const uint32_t height )
+   {
+      if (width != width_ || height != height_)
+      {
+         width_ = width;
+         height_ = height;
+
+         if (immutable_storage_)
+         {
+            // immutable storage cannot be respecified, so the
+            // textures are replaced and attached again
+            DeleteTextures();
+            CreateImmutableTextures();
+            Attach();
+         }
+         else if (!color_)
+         {
+            CreateMutableTextures();
+            Attach();
+         }
+         else
+         {
+            // the previous render target path respecified the
+            // textures in place and left them attached
+            SpecifyMutableTextures();
+         }
+      }
+
+      return Complete();
+   }
+
+   void DrawFrame( ) const
+   {
+      gl_.glBindFramebuffer(GL_FRAMEBUFFER, multisample_frame_buffer_);
+
+      glViewport(
+         0, 0,
+         static_cast< GLsizei >(width_),
+         static_cast< GLsizei >(height_));
+      glClearColor(0.2f, 0.2f, 0.4f, 1.0f);
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+      gl_.glBindFramebuffer(GL_READ_FRAMEBUFFER, multisample_frame_buffer_);
+      gl_.glBindFramebuffer(GL_DRAW_FRAMEBUFFER, resolve_frame_buffer_);
+      gl_.glBlitFramebuffer(
+         0, 0, static_cast< GLint >(width_), static_cast< GLint >(height_),
+         0, 0, static_cast< GLint >(width_), static_cast< GLint >(height_),
+         GL_COLOR_BUFFER_BIT,
+         GL_NEAREST);
+
+      gl_.glBindFramebuffer(GL_FRAMEBUFFER, 0);
+   }
+
+private:
+   void CreateMutableTextures( )
+   {
+      glGenTextures(1, &color_);
+      glGenTextures(1, &multisample_color_);
+      glGenTextures(1, &multisample_depth_);
+
+      SpecifyMutableTextures();
+   }
+
+   void SpecifyMutableTextures( ) const
+   {
+      glBindTexture(GL_TEXTURE_2D, color_);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+      glTexImage2D(
+         GL_TEXTURE_2D, 0, GL_RGBA8,
+         static_cast< GLsizei >(width_), static_cast< GLsizei >(height_),
+         0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+      glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, multisample_color_);
+      gl_.glTexImage2DMultisample(
+         GL_TEXTURE_2D_MULTISAMPLE, SAMPLES, GL_RGBA8,
+         static_cast< GLsizei >(width_), static_cast< GLsizei >(height_),
+         GL_FALSE);
+
+      glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, multisample_depth_);
+      gl_.glTexImage2DMultisample(
+         GL_TEXTURE_2D_MULTISAMPLE, SAMPLES, GL_DEPTH32F_STENCIL8,
+         static_cast< GLsizei >(width_), static_cast< GLsizei >(height_),
+         GL_FALSE);
+   }
+
+   void CreateImmutableTextures( )
+   {
+      glGenTextures(1, &color_);
+      glGenTextures(1, &multisample_color_);
+      glGenTextures(1, &multisample_depth_);
+
+      glBindTexture(GL_TEXTURE_2D, color_);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+      gl_.glTexStorage2D(
+         GL_TEXTURE_2D, 1, GL_RGBA8,
+         static_cast< GLsizei >(width_), static_cast< GLsizei >(height_));
+
+      glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, multisample_color_);
+      gl_.glTexStorage2DMultisample(
+         GL_TEXTURE_2D_MULTISAMPLE, SAMPLES, GL_RGBA8,
+         static_cast< GLsizei >(width_), static_cast< GLsizei >(height_),
+         GL_FALSE);
+
+      glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, multisample_depth_);
+      gl_.glTexStorage2DMultisample(
+         GL_TEXTURE_2D_MULTISAMPLE, SAMPLES, GL_DEPTH32F_STENCIL8,
+         static_cast< GLsizei >(width_), static_cast< GLsizei >(height_),
+         GL_FALSE);
+   }
+
+   void DeleteTextures( )
+   {
+      const GLuint textures[] {
+         color_, multisample_color_, multisample_depth_ };
+
+      if (color_)
+      {
+         glDeleteTextures(3, textures);
+      }
+
+      color_ = multisample_color_ = multisample_depth_ = 0;
+   }
+
+   void Attach( ) const
+   {
+      gl_.glBindFramebuffer(GL_FRAMEBUFFER, multisample_frame_buffer_);
+      gl_.glFramebufferTexture2D(
+         GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+         GL_TEXTURE_2D_MULTISAMPLE, multisample_color_, 0);
+      gl_.glFramebufferTexture2D(
+         GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+         GL_TEXTURE_2D_MULTISAMPLE, multisample_depth_, 0);
+
+      gl_.glBindFramebuffer(GL_FRAMEBUFFER, resolve_frame_buffer_);
+      gl_.glFramebufferTexture2D(
+         GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+         GL_TEXTURE_2D, color_, 0);
+
+      gl_.glBindFramebuffer(GL_FRAMEBUFFER, 0);
+   }
+
+   bool Complete( ) const
+   {
+      bool complete { true };
+
+      for (const auto frame_buffer :
+           { multisample_frame_buffer_, resolve_frame_buffer_ })
+      {
+         gl_.glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
+
+         complete =
+            complete &&
+            gl_.glCheckFramebufferStatus(GL_FRAMEBUFFER) ==
+            GL_FRAMEBUFFER_COMPLETE;
+      }
+
+      gl_.glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+      return complete;
+   }
+
+   const bool immutable_storage_;
+
+   uint32_t width_ { 0 };
+   uint32_t height_ { 0 };
+
+   GLuint multisample_frame_buffer_ { 0 };
+   GLuint resolve_frame_buffer_ { 0 };
+
+   GLuint color_ { 0 };
+   GLuint multisample_color_ { 0 };
+   GLuint multisample_depth_ { 0 };
+
+};
+
+template < typename Size >
+void Measure(
+   const char * const name,
+   const bool immutable_storage,
+   Size && size )
+{
+   RenderTargets render_targets {
+      immutable_storage };
+
+   std::vector< std::chrono::nanoseconds > frame_times;
+   frame_times.reserve(FRAMES);
+
+   bool complete { true };
+
+   for (size_t i { 0 }; i < WARMUP_FRAMES + FRAMES; ++i)
+   {
+      const auto frame_start =
+         std::chrono::steady_clock::now();
+
+      const auto frame_size =
+         size(i);
+
+      complete =
+         render_targets.Resize(
+            frame_size.first,
+            frame_size.second) &&
+         complete;
+
+      render_targets.DrawFrame();
+
+      // the frame time includes the gpu time of the frame
+      glFinish();
+
+      if (i >= WARMUP_FRAMES)
+      {
+         frame_times.push_back(
+            std::chrono::duration_cast< std::chrono::nanoseconds >(
+               std::chrono::steady_clock::now() - frame_start));
+      }
+   }
+
+   std::sort(
+      frame_times.begin(),
+      frame_times.end());
+
+   std::chrono::nanoseconds total { 0 };
+
+   for (const auto frame_time : frame_times)
+   {
+      total += frame_time;
+   }
+
+   std::cout
+      << name
+      << ": "
+      << total.count() / frame_times.size() / 1000
+      << " us/frame, "
+      << frame_times[frame_times.size() * 99 / 100].count() / 1000
+      << " us p99"
+      << (complete ? "" : " (incomplete frame buffer)")
+      << std::endl;
+}
+
+osg::ref_ptr< osg::GraphicsContext > CreateGraphicsContext( )
+{
+   osg::ref_ptr< osg::GraphicsContext::Traits > gc_traits {
+      new osg::GraphicsContext::Traits };
+
+   gc_traits->width = 1;
+   gc_traits->height = 1;
+   gc_traits->windowDecoration = false;
+   gc_traits->doubleBuffer = false;
+   gc_traits->pbuffer = true;
+   gc_traits->glContextVersion = "4.3";
+
+   const osg::ref_ptr< osg::GraphicsContext > graphics_context =
+      osg::GraphicsContext::createGraphicsContext(
+         gc_traits.get());
+
+   if (graphics_context)
+   {
+      graphics_context->realize();
+   }
+
+   return graphics_context;
+}
+
+} // namespace
+
+int main( )
+{
+   // using osgViewer registers the windowing systems
+   std::cout
+      << "osgViewer "
+      << osgViewerGetVersion()
+      << ", "
+      << SAMPLES
+      << " samples"
+      << std::endl;
+
+   const auto graphics_context =
+      CreateGraphicsContext();
+
+   if (!graphics_context ||
+       !graphics_context->makeCurrent())
+   {
+      std::cerr
+         << "Unable to create a graphics context"
+         << std::endl;
+
+      return 1;
+   }
+
+   int result { 0 };
+
+   if (!gl_.Load())
+   {
+      std::cerr
+         << "Immutable multisample storage is not supported"
+         << std::endl;
+
+      result = 1;
+   }
+   else
+   {
+      const auto steady =
+         [ ] ( const size_t )
+         {
+            return std::make_pair(STEADY_WIDTH, STEADY_HEIGHT);
+         };
+
+      const auto resizing =
+         [ ] ( const size_t frame )
+         {
+            const auto step =
+               static_cast< uint32_t >(frame % RESIZE_STEPS);
+
+            return
+               std::make_pair(
+                  STEADY_WIDTH + step * RESIZE_STEP,
+                  STEADY_HEIGHT + step * RESIZE_STEP / 2);
+         };
+
+      Measure("mutable storage steady state", false, steady);
+      Measure("immutable storage steady state", true, steady);
+      Measure("mutable storage respecified every frame", false, resizing);
+      Measure("immutable storage replaced every frame", true, resizing);
+   }
+
+   graphics_context->releaseContext();
+
+   return result;
+}
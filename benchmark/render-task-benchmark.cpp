@@ -0,0 +1,282 @@
+#include "../mpsc-queue.h"
+#include "../render-task.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+
+static std::atomic< uint64_t > heap_allocations_ { 0 };
+
+void * operator new(
+   std::size_t size )
+{
+   heap_allocations_.fetch_add(
+      1,
+      std::memory_order_relaxed);
+
+   if (const auto memory = std::malloc(size ? size : 1))
+   {
+      return memory;
+   }
+
+   throw std::bad_alloc { };
+}
+
+void operator delete(
+   void * memory ) noexcept
+{
+   std::free(memory);
+}
+
+void operator delete(
+   void * memory,
+   std::size_t ) noexcept
+{
+   std::free(memory);
+}
+
+namespace
+{
+
+// mirrors the operation queued by the render thread
+struct Operation
+{
+   RenderTask task;
+   RenderTaskCompletion completion;
+   std::chrono::steady_clock::time_point added;
+};
+
+// same shape as the previous render thread operation
+struct LegacyOperation
+{
+   std::function< void ( ) > operation;
+   std::chrono::steady_clock::time_point added;
+};
+
+// typical camera update posted to the render thread
+struct CameraLookAt
+{
+   std::array< double, 3 > eye;
+   std::array< double, 3 > center;
+   std::array< double, 3 > up;
+};
+
+constexpr size_t WARMUP_ITERATIONS { 1024 };
+constexpr size_t ITERATIONS { 1000000 };
+
+template < typename Post, typename Drain >
+void Measure(
+   const char * const name,
+   Post && post,
+   Drain && drain )
+{
+   for (size_t i { 0 }; i < WARMUP_ITERATIONS; ++i)
+   {
+      post(i);
+      drain();
+   }
+
+   const auto allocations_start =
+      heap_allocations_.load();
+   const auto time_start =
+      std::chrono::steady_clock::now();
+
+   for (size_t i { 0 }; i < ITERATIONS; ++i)
+   {
+      post(i);
+      drain();
+   }
+
+   const auto time_end =
+      std::chrono::steady_clock::now();
+   const auto allocations =
+      heap_allocations_.load() - allocations_start;
+
+   std::cout
+      << name
+      << ": "
+      << std::chrono::duration_cast< std::chrono::nanoseconds >(
+            time_end - time_start).count() / ITERATIONS
+      << " ns/op, "
+      << static_cast< double >(allocations) / ITERATIONS
+      << " allocations/op"
+      << std::endl;
+}
+
+} // namespace
+
+int main( )
+{
+   CameraLookAt camera { };
+   double sink { 0.0 };
+
+   {
+      MPSCQueue< LegacyOperation > operations;
+      LegacyOperation operation;
+
+      Measure(
+         "legacy std::function + shared_ptr< promise >",
+         [ & ] ( const size_t i )
+         {
+            auto complete =
+               std::make_shared< std::promise< void > >();
+            auto completed =
+               complete->get_future();
+
+            camera.eye[0] = static_cast< double >(i);
+
+            operations.Push(
+               LegacyOperation {
+                  [ complete = std::move(complete),
+                    operation = std::function< void ( ) > {
+                       [ & sink, camera ] ( )
+                       {
+                          sink += camera.eye[0];
+                       } } ] ( ) mutable
+                  {
+                     operation();
+
+                     complete->set_value();
+                  },
+                  std::chrono::steady_clock::now() });
+         },
+         [ & ] ( )
+         {
+            while (operations.Pop(operation))
+            {
+               operation.operation();
+            }
+         });
+   }
+
+   {
+      MPSCQueue< Operation > operations;
+      Operation operation;
+
+      Measure(
+         "render task with pooled completion",
+         [ & ] ( const size_t i )
+         {
+            std::future< void > completed;
+
+            camera.eye[0] = static_cast< double >(i);
+
+            operations.Push(
+               Operation {
+                  [ & sink, camera ] ( )
+                  {
+                     sink += camera.eye[0];
+                  },
+                  RenderTaskCompletion::Create(completed),
+                  std::chrono::steady_clock::now() });
+         },
+         [ & ] ( )
+         {
+            while (operations.Pop(operation))
+            {
+               operation.task();
+               operation.completion.Complete();
+            }
+         });
+
+      Measure(
+         "render task fire and forget",
+         [ & ] ( const size_t i )
+         {
+            camera.eye[0] = static_cast< double >(i);
+
+            operations.Push(
+               Operation {
+                  [ & sink, camera ] ( )
+                  {
+                     sink += camera.eye[0];
+                  },
+                  RenderTaskCompletion { },
+                  std::chrono::steady_clock::now() });
+         },
+         [ & ] ( )
+         {
+            while (operations.Pop(operation))
+            {
+               operation.task();
+               operation.completion.Complete();
+            }
+         });
+   }
+
+   {
+      // producers on other threads exercise the node recycling
+      MPSCQueue< Operation > operations;
+      std::atomic_bool quit { false };
+
+      std::thread consumer {
+         [ & ] ( )
+         {
+            Operation operation;
+
+            while (!quit || operations.Size())
+            {
+               while (operations.Pop(operation))
+               {
+                  operation.task();
+               }
+            }
+         } };
+
+      std::atomic< uint64_t > executed { 0 };
+
+      const auto produce =
+         [ & ] ( )
+         {
+            for (size_t i { 0 }; i < ITERATIONS; ++i)
+            {
+               operations.Push(
+                  Operation {
+                     [ & executed ] ( )
+                     {
+                        executed.fetch_add(
+                           1,
+                           std::memory_order_relaxed);
+                     },
+                     RenderTaskCompletion { },
+                     std::chrono::steady_clock::now() });
+            }
+         };
+
+      const auto time_start =
+         std::chrono::steady_clock::now();
+
+      std::thread producer0 { produce };
+      std::thread producer1 { produce };
+
+      producer0.join();
+      producer1.join();
+
+      quit = true;
+
+      consumer.join();
+
+      const auto time_end =
+         std::chrono::steady_clock::now();
+
+      std::cout
+         << "two producers one consumer: "
+         << std::chrono::duration_cast< std::chrono::nanoseconds >(
+               time_end - time_start).count() / (2 * ITERATIONS)
+         << " ns/op, "
+         << executed.load()
+         << " executed"
+         << std::endl;
+   }
+
+   return sink < 0.0;
+}
@@ -0,0 +1,149 @@
+#ifndef _BLOCK_POOL_H_
+#define _BLOCK_POOL_H_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+// recycles fixed size blocks instead of returning them to the
+// heap.  blocks can be released from any thread, so the free
+// list is guarded by a mutex that is only held for a pointer swap.
+template < size_t SIZE, size_t ALIGNMENT >
+class BlockPool final
+{
+public:
+   static void * Allocate( ) noexcept;
+   static void Release(
+      void * const block ) noexcept;
+
+private:
+   union Block
+   {
+      Block * next;
+      std::aligned_storage_t< SIZE, ALIGNMENT > storage;
+   };
+
+   static std::mutex & Mutex( ) noexcept;
+   static Block * & FreeBlocks( ) noexcept;
+
+};
+
+template < size_t SIZE, size_t ALIGNMENT >
+inline void * BlockPool< SIZE, ALIGNMENT >::Allocate( ) noexcept
+{
+   Block * block { nullptr };
+
+   {
+#if _has_cxx_class_template_argument_deduction
+      std::lock_guard lock {
+         Mutex() };
+#else
+      std::lock_guard< std::mutex > lock {
+         Mutex() };
+#endif
+
+      block = FreeBlocks();
+
+      if (block)
+      {
+         FreeBlocks() = block->next;
+      }
+   }
+
+   return
+      block ?
+      block :
+      new Block;
+}
+
+template < size_t SIZE, size_t ALIGNMENT >
+inline void BlockPool< SIZE, ALIGNMENT >::Release(
+   void * const block ) noexcept
+{
+   const auto free_block =
+      static_cast< Block * >(block);
+
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      Mutex() };
+#else
+   std::lock_guard< std::mutex > lock {
+      Mutex() };
+#endif
+
+   free_block->next = FreeBlocks();
+   FreeBlocks() = free_block;
+}
+
+template < size_t SIZE, size_t ALIGNMENT >
+inline std::mutex &
+BlockPool< SIZE, ALIGNMENT >::Mutex( ) noexcept
+{
+   static std::mutex mutex;
+
+   return mutex;
+}
+
+template < size_t SIZE, size_t ALIGNMENT >
+inline typename BlockPool< SIZE, ALIGNMENT >::Block * &
+BlockPool< SIZE, ALIGNMENT >::FreeBlocks( ) noexcept
+{
+   static Block * free_blocks { nullptr };
+
+   return free_blocks;
+}
+
+// allocates single objects from the block pool of their size, such
+// as the shared states of promises and of allocate shared, and falls
+// back to the heap for arrays
+template < typename T >
+struct BlockPoolAllocator
+{
+   using value_type = T;
+
+   BlockPoolAllocator( ) noexcept = default;
+   template < typename U >
+   BlockPoolAllocator(
+      const BlockPoolAllocator< U > & ) noexcept { }
+
+   T * allocate(
+      const size_t n )
+   {
+      return
+         n == 1 ?
+         static_cast< T * >(
+            BlockPool< sizeof(T), alignof(T) >::Allocate()) :
+         std::allocator< T > { }.allocate(n);
+   }
+
+   void deallocate(
+      T * const t,
+      const size_t n ) noexcept
+   {
+      if (n == 1)
+      {
+         BlockPool< sizeof(T), alignof(T) >::Release(t);
+      }
+      else
+      {
+         std::allocator< T > { }.deallocate(t, n);
+      }
+   }
+
+   template < typename U >
+   bool operator == (
+      const BlockPoolAllocator< U > & ) const noexcept
+   {
+      return true;
+   }
+
+   template < typename U >
+   bool operator != (
+      const BlockPoolAllocator< U > & ) const noexcept
+   {
+      return false;
+   }
+};
+
+#endif // _BLOCK_POOL_H_
@@ -0,0 +1,261 @@
+#include "color-buffer-pool.h"
+
+#include <osg/Texture>
+#include <osg/Texture2DArray>
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace color_buffer_pool
+{
+
+struct PooledTextureArray
+{
+   osg::ref_ptr< osg::Texture2DArray > texture;
+
+   // one entry per layer of the texture array
+   std::vector< bool > reserved;
+   size_t reserved_count;
+};
+
+static std::map< Key, std::list< PooledTextureArray > > texture_arrays_;
+static std::mutex texture_arrays_mutex_;
+
+static osg::ref_ptr< osg::Texture2DArray > CreateTextureArray(
+   const uint32_t width,
+   const uint32_t height,
+   const GLenum internal_format,
+   const uint32_t layers )
+{
+   osg::ref_ptr< osg::Texture2DArray > texture_array {
+      new osg::Texture2DArray };
+
+   // without images the storage of every layer is
+   // allocated when the texture is first applied
+   texture_array->setTextureSize(
+      width,
+      height,
+      layers);
+   texture_array->setInternalFormat(internal_format);
+   texture_array->setSourceFormat(GL_RGBA);
+   texture_array->setSourceType(GL_UNSIGNED_BYTE);
+   texture_array->setWrap(
+      osg::Texture::WrapParameter::WRAP_S,
+      osg::Texture::WrapMode::CLAMP_TO_EDGE);
+   texture_array->setWrap(
+      osg::Texture::WrapParameter::WRAP_T,
+      osg::Texture::WrapMode::CLAMP_TO_EDGE);
+   texture_array->setFilter(
+      osg::Texture::FilterParameter::MIN_FILTER,
+      osg::Texture::FilterMode::NEAREST);
+   texture_array->setFilter(
+      osg::Texture::FilterParameter::MAG_FILTER,
+      osg::Texture::FilterMode::NEAREST);
+   texture_array->setResizeNonPowerOfTwoHint(false);
+
+   return texture_array;
+}
+
+static void Release(
+   const Key & key,
+   const osg::Texture2DArray & texture_array,
+   const uint32_t layer )
+{
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      texture_arrays_mutex_ };
+#else
+   std::lock_guard< decltype(texture_arrays_mutex_) > lock {
+      texture_arrays_mutex_ };
+#endif
+
+   const auto key_texture_arrays =
+      texture_arrays_.find(
+         key);
+
+   if (key_texture_arrays != texture_arrays_.end())
+   {
+      auto & texture_arrays =
+         key_texture_arrays->second;
+
+      const auto pooled_texture_array =
+         std::find_if(
+            texture_arrays.begin(),
+            texture_arrays.end(),
+            [ & texture_array ] ( const auto & pooled_texture_array )
+            {
+               return pooled_texture_array.texture == &texture_array;
+            });
+
+      if (pooled_texture_array != texture_arrays.end() &&
+          pooled_texture_array->reserved[layer])
+      {
+         pooled_texture_array->reserved[layer] = false;
+
+         // an unused texture array is freed once the frame
+         // buffers still attached to it go away
+         if (--pooled_texture_array->reserved_count == 0)
+         {
+            texture_arrays.erase(
+               pooled_texture_array);
+         }
+
+         if (texture_arrays.empty())
+         {
+            texture_arrays_.erase(
+               key_texture_arrays);
+         }
+      }
+   }
+}
+
+Layer::Layer(
+   const Key & key,
+   osg::ref_ptr< osg::Texture2DArray > texture_array,
+   const uint32_t layer ) noexcept :
+key_ { key },
+texture_array_ { std::move(texture_array) },
+layer_ { layer }
+{
+}
+
+Layer::~Layer( ) noexcept
+{
+   Release(
+      key_,
+      *texture_array_,
+      layer_);
+}
+
+osg::Texture2DArray & Layer::TextureArray( ) const noexcept
+{
+   return *texture_array_;
+}
+
+uint32_t Layer::Index( ) const noexcept
+{
+   return layer_;
+}
+
+osg::ref_ptr< Layer > Acquire(
+   const uint32_t context_id,
+   const uint32_t width,
+   const uint32_t height,
+   const GLenum internal_format,
+   const uint32_t layers_per_texture_array ) noexcept
+{
+   const Key key {
+      context_id,
+      width,
+      height,
+      internal_format };
+
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      texture_arrays_mutex_ };
+#else
+   std::lock_guard< decltype(texture_arrays_mutex_) > lock {
+      texture_arrays_mutex_ };
+#endif
+
+   auto & texture_arrays =
+      texture_arrays_[key];
+
+   auto texture_array =
+      std::find_if(
+         texture_arrays.begin(),
+         texture_arrays.end(),
+         [ ] ( const auto & texture_array )
+         {
+            return
+               texture_array.reserved_count <
+               texture_array.reserved.size();
+         });
+
+   if (texture_array == texture_arrays.end())
+   {
+      const uint32_t layers {
+         std::max< uint32_t >(layers_per_texture_array, 1) };
+
+      texture_array =
+         texture_arrays.insert(
+            texture_arrays.end(),
+            PooledTextureArray {
+               CreateTextureArray(
+                  width,
+                  height,
+                  internal_format,
+                  layers),
+               std::vector< bool >(layers, false),
+               0 });
+   }
+
+   const auto layer =
+      static_cast< uint32_t >(
+         std::distance(
+            texture_array->reserved.cbegin(),
+            std::find(
+               texture_array->reserved.cbegin(),
+               texture_array->reserved.cend(),
+               false)));
+
+   texture_array->reserved[layer] = true;
+   ++texture_array->reserved_count;
+
+   return
+      new Layer {
+         key,
+         texture_array->texture,
+         layer };
+}
+
+size_t ReservedLayers( ) noexcept
+{
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      texture_arrays_mutex_ };
+#else
+   std::lock_guard< decltype(texture_arrays_mutex_) > lock {
+      texture_arrays_mutex_ };
+#endif
+
+   size_t reserved_layers { 0 };
+
+   for (const auto & texture_arrays : texture_arrays_)
+   {
+      for (const auto & texture_array : texture_arrays.second)
+      {
+         reserved_layers += texture_array.reserved_count;
+      }
+   }
+
+   return reserved_layers;
+}
+
+size_t AllocatedLayers( ) noexcept
+{
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      texture_arrays_mutex_ };
+#else
+   std::lock_guard< decltype(texture_arrays_mutex_) > lock {
+      texture_arrays_mutex_ };
+#endif
+
+   size_t allocated_layers { 0 };
+
+   for (const auto & texture_arrays : texture_arrays_)
+   {
+      for (const auto & texture_array : texture_arrays.second)
+      {
+         allocated_layers += texture_array.reserved.size();
+      }
+   }
+
+   return allocated_layers;
+}
+
+} // namespace color_buffer_pool
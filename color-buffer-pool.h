@@ -0,0 +1,78 @@
+#ifndef _COLOR_BUFFER_POOL_H_
+#define _COLOR_BUFFER_POOL_H_
+
+#include <osg/Referenced>
+#include <osg/ref_ptr>
+
+#if _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <GL/GL.h>
+#elif __linux__
+#include <GL/gl.h>
+#else
+#error "Define for this platform!"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+
+namespace osg
+{
+class Texture2DArray;
+}
+
+namespace color_buffer_pool
+{
+
+// context id, width, height and internal format
+using Key =
+   std::tuple< uint32_t, uint32_t, uint32_t, GLenum >;
+
+// a layer of a texture array reserved by a view.  the layer is
+// returned to the pool once the last reference goes away.
+class Layer final :
+   public osg::Referenced
+{
+public:
+   Layer(
+      const Key & key,
+      osg::ref_ptr< osg::Texture2DArray > texture_array,
+      const uint32_t layer ) noexcept;
+
+   osg::Texture2DArray & TextureArray( ) const noexcept;
+   uint32_t Index( ) const noexcept;
+
+protected:
+   ~Layer( ) noexcept override;
+
+private:
+   const Key key_;
+   const osg::ref_ptr< osg::Texture2DArray > texture_array_;
+   const uint32_t layer_;
+
+};
+
+// views of the same size share the layers of one texture array
+// instead of allocating a texture each.  the texture arrays are
+// created for the context id of the calling context, so the layers
+// are only shared when the views share a context id.  a texture
+// array is created with the given number of layers once the arrays
+// of the key are full, so a view with a context id of its own sizes
+// them for its swap chain.  must be called with that context current
+// and its gl objects locked.
+osg::ref_ptr< Layer > Acquire(
+   const uint32_t context_id,
+   const uint32_t width,
+   const uint32_t height,
+   const GLenum internal_format,
+   const uint32_t layers_per_texture_array ) noexcept;
+
+// layers reserved by the views and allocated in total
+size_t ReservedLayers( ) noexcept;
+size_t AllocatedLayers( ) noexcept;
+
+} // namespace color_buffer_pool
+
+#endif // _COLOR_BUFFER_POOL_H_
@@ -0,0 +1,49 @@
+#ifndef _COLOR_BUFFER_H_
+#define _COLOR_BUFFER_H_
+
+#if _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <GL/GL.h>
+#elif __linux__
+#include <GL/gl.h>
+#else
+#error "Define for this platform!"
+#endif
+
+#include <tuple>
+
+// the color target a view renders a frame into and hands to
+// its consumer.  a color buffer is either a 2d texture or a
+// layer of a 2d texture array shared with other views.
+struct ColorBuffer
+{
+   GLuint texture_id { 0 };
+   // the layer of the texture array or -1 for a 2d texture
+   GLint layer { -1 };
+
+   // the frame covers the lower left of the buffer, which may be
+   // larger than the frame.  not a part of the buffer identity.
+   GLsizei width { 0 };
+   GLsizei height { 0 };
+};
+
+inline bool operator == (
+   const ColorBuffer & lhs,
+   const ColorBuffer & rhs ) noexcept
+{
+   return
+      lhs.texture_id == rhs.texture_id &&
+      lhs.layer == rhs.layer;
+}
+
+inline bool operator < (
+   const ColorBuffer & lhs,
+   const ColorBuffer & rhs ) noexcept
+{
+   return
+      std::tie(lhs.texture_id, lhs.layer) <
+      std::tie(rhs.texture_id, rhs.layer);
+}
+
+#endif // _COLOR_BUFFER_H_
@@ -0,0 +1,281 @@
+#include "fence-watcher.h"
+#include "color-buffer.h"
+#include "gl-fence-sync.h"
+#include "render-thread.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QEvent>
+#include <QtCore/QObject>
+
+#include <osg/GraphicsContext>
+
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+extern osg::ref_ptr< osg::GraphicsContext >
+CreateSharedGraphicsContext(
+   const char * const context_name ) noexcept;
+
+const int32_t FRAME_READY_EVENT =
+   QEvent::registerEventType();
+
+namespace fence_watcher
+{
+
+// the watcher blocks on the oldest fence for several frames, so the
+// timeout only bounds how long a fence that never signals holds back
+// the fences of the other render threads and the stop of the watcher
+static const std::chrono::milliseconds WAIT_TIMEOUT { 100 };
+
+struct WatchedFence
+{
+   std::shared_ptr< std::pair< ColorBuffer, gl::FenceSync > > fence_sync;
+   QObject * receiver;
+};
+
+static std::thread watcher_thread_;
+static std::mutex watcher_thread_mutex_;
+
+static osg::ref_ptr< osg::GraphicsContext > watcher_graphics_context_;
+
+static std::list< WatchedFence > watched_fences_;
+// fences can only be deleted with a current context, so the fences
+// that are no longer watched are released on the watcher thread
+static std::vector< WatchedFence > released_fences_;
+static std::mutex watched_fences_mutex_;
+static std::condition_variable watched_fences_condition_;
+static bool quit_watcher_thread_ { false };
+
+static void WatcherLoop( )
+{
+   watcher_graphics_context_->makeCurrent();
+
+   while (true)
+   {
+      std::shared_ptr< std::pair< ColorBuffer, gl::FenceSync > > oldest_fence;
+
+      {
+         std::unique_lock< std::mutex > lock {
+            watched_fences_mutex_ };
+
+         watched_fences_condition_.wait(
+            lock,
+            [ ] ( )
+            {
+               return
+                  quit_watcher_thread_ ||
+                  !watched_fences_.empty() ||
+                  !released_fences_.empty();
+            });
+
+         released_fences_.clear();
+
+         if (quit_watcher_thread_)
+         {
+            watched_fences_.clear();
+
+            break;
+         }
+
+         if (watched_fences_.empty())
+         {
+            continue;
+         }
+
+         oldest_fence =
+            watched_fences_.front().fence_sync;
+      }
+
+      // the fences watched after the oldest one are only checked once
+      // it signals or the wait times out.  a new fence or an unwatch
+      // does not interrupt the wait, as the new fence is not reported
+      // ahead of the oldest one and the fences of an unwatched receiver
+      // are no longer in the list when the wait returns.
+      oldest_fence->second.ClientWait(
+         WAIT_TIMEOUT);
+
+#if _has_cxx_class_template_argument_deduction
+      std::lock_guard lock {
+         watched_fences_mutex_ };
+#else
+      std::lock_guard< decltype(watched_fences_mutex_) > lock {
+         watched_fences_mutex_ };
+#endif
+
+      // fences of different render threads signal in any order
+      for (auto watched_fence = watched_fences_.begin();
+           watched_fence != watched_fences_.end();)
+      {
+         if (watched_fence->fence_sync->second.IsSignaled())
+         {
+            QCoreApplication::postEvent(
+               watched_fence->receiver,
+               new QEvent {
+                  static_cast< QEvent::Type >(FRAME_READY_EVENT) },
+               Qt::HighEventPriority);
+
+            released_fences_.emplace_back(
+               std::move(*watched_fence));
+
+            watched_fence =
+               watched_fences_.erase(
+                  watched_fence);
+         }
+         else
+         {
+            ++watched_fence;
+         }
+      }
+   }
+
+   released_fences_.clear();
+
+   watcher_graphics_context_->releaseContext();
+}
+
+void Start( ) noexcept
+{
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      watcher_thread_mutex_ };
+#else
+   std::lock_guard< decltype(watcher_thread_mutex_) > lock {
+      watcher_thread_mutex_ };
+#endif
+
+   if (watcher_thread_.get_id() == std::thread::id { })
+   {
+      render_thread::AddOperation(
+         [ ] ( )
+         {
+            watcher_graphics_context_ =
+               CreateSharedGraphicsContext(
+                  "fence watcher graphics context");
+         }).wait();
+
+      if (watcher_graphics_context_)
+      {
+         quit_watcher_thread_ = false;
+
+         watcher_thread_ =
+            std::thread {
+               &WatcherLoop };
+      }
+   }
+}
+
+void Stop( ) noexcept
+{
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      watcher_thread_mutex_ };
+#else
+   std::lock_guard< decltype(watcher_thread_mutex_) > lock {
+      watcher_thread_mutex_ };
+#endif
+
+   if (watcher_thread_.get_id() != std::thread::id { })
+   {
+      {
+#if _has_cxx_class_template_argument_deduction
+         std::lock_guard fences_lock {
+            watched_fences_mutex_ };
+#else
+         std::lock_guard< decltype(watched_fences_mutex_) > fences_lock {
+            watched_fences_mutex_ };
+#endif
+
+         quit_watcher_thread_ = true;
+      }
+
+      watched_fences_condition_.notify_one();
+
+      watcher_thread_.join();
+
+      watcher_thread_ = std::thread { };
+
+      render_thread::AddOperation(
+         [ ] ( )
+         {
+            watcher_graphics_context_ = nullptr;
+         }).wait();
+   }
+}
+
+bool Running( ) noexcept
+{
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      watcher_thread_mutex_ };
+#else
+   std::lock_guard< decltype(watcher_thread_mutex_) > lock {
+      watcher_thread_mutex_ };
+#endif
+
+   return
+      watcher_thread_.get_id() != std::thread::id { };
+}
+
+void Watch(
+   std::shared_ptr< std::pair< ColorBuffer, gl::FenceSync > > fence_sync,
+   QObject & receiver ) noexcept
+{
+   if (fence_sync &&
+       fence_sync->second.Valid())
+   {
+      {
+#if _has_cxx_class_template_argument_deduction
+         std::lock_guard lock {
+            watched_fences_mutex_ };
+#else
+         std::lock_guard< decltype(watched_fences_mutex_) > lock {
+            watched_fences_mutex_ };
+#endif
+
+         watched_fences_.push_back(
+            WatchedFence {
+               std::move(fence_sync),
+               &receiver });
+      }
+
+      watched_fences_condition_.notify_one();
+   }
+}
+
+void Unwatch(
+   const QObject & receiver ) noexcept
+{
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      watched_fences_mutex_ };
+#else
+   std::lock_guard< decltype(watched_fences_mutex_) > lock {
+      watched_fences_mutex_ };
+#endif
+
+   for (auto watched_fence = watched_fences_.begin();
+        watched_fence != watched_fences_.end();)
+   {
+      if (watched_fence->receiver == &receiver)
+      {
+         released_fences_.emplace_back(
+            std::move(*watched_fence));
+
+         watched_fence =
+            watched_fences_.erase(
+               watched_fence);
+      }
+      else
+      {
+         ++watched_fence;
+      }
+   }
+
+   watched_fences_condition_.notify_one();
+}
+
+} // namespace fence_watcher
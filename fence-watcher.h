@@ -0,0 +1,47 @@
+#ifndef _FENCE_WATCHER_H_
+#define _FENCE_WATCHER_H_
+
+#if _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <GL/GL.h>
+#elif __linux__
+#include <GL/gl.h>
+#else
+#error "Define for this platform!"
+#endif
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+class QObject;
+struct ColorBuffer;
+
+namespace gl
+{
+class FenceSync;
+}
+
+// posted to the receiver of a watched fence once it has signaled
+extern const int32_t FRAME_READY_EVENT;
+
+namespace fence_watcher
+{
+
+// the watcher thread waits on the fences with a context that shares
+// with the hidden gl context, so the render thread must be started
+void Start( ) noexcept;
+void Stop( ) noexcept;
+bool Running( ) noexcept;
+
+void Watch(
+   std::shared_ptr< std::pair< ColorBuffer, gl::FenceSync > > fence_sync,
+   QObject & receiver ) noexcept;
+// no frame ready events are posted to the receiver once this returns
+void Unwatch(
+   const QObject & receiver ) noexcept;
+
+} // namespace fence_watcher
+
+#endif // _FENCE_WATCHER_H_
@@ -0,0 +1,140 @@
+#include "frame-pacer.h"
+
+#include <algorithm>
+#include <thread>
+
+// sleeping is only accurate to the scheduler quantum, so the
+// final stretch before a deadline is spent spinning instead
+static const std::chrono::microseconds SPIN_DURATION { 1500 };
+// margin added to the frame cost when rendering late
+static const std::chrono::microseconds RENDER_LATE_MARGIN { 1000 };
+
+FramePacer::FramePacer( ) noexcept :
+frame_period_ { Clock::duration::zero() },
+render_late_ { false },
+deadline_ { Clock::now() },
+frame_start_ { deadline_ },
+last_frame_cost_ { Clock::duration::zero() },
+frame_cost_estimate_ { Clock::duration::zero() },
+frames_ { 0 },
+missed_deadlines_ { 0 }
+{
+}
+
+void FramePacer::SetTargetFrameRate(
+   const double frames_per_second ) noexcept
+{
+   const auto frame_period =
+      frames_per_second > 0.0 ?
+      std::chrono::duration_cast< Clock::duration >(
+         std::chrono::duration< double > { 1.0 / frames_per_second }) :
+      Clock::duration::zero();
+
+   if (frame_period != frame_period_)
+   {
+      frame_period_ = frame_period;
+
+      deadline_ =
+         Clock::now() + frame_period_;
+   }
+}
+
+void FramePacer::SetRenderLate(
+   const bool render_late ) noexcept
+{
+   render_late_ = render_late;
+}
+
+void FramePacer::BeginFrame( ) noexcept
+{
+   if (frame_period_ != Clock::duration::zero())
+   {
+      const auto frame_slot_start =
+         deadline_ - frame_period_;
+
+      const auto frame_start =
+         render_late_ ?
+         std::max(
+            frame_slot_start,
+            deadline_ -
+            frame_cost_estimate_ -
+            std::chrono::duration_cast< Clock::duration >(
+               RENDER_LATE_MARGIN)) :
+         frame_slot_start;
+
+      SleepUntil(
+         frame_start);
+   }
+
+   frame_start_ =
+      Clock::now();
+}
+
+void FramePacer::EndFrame( ) noexcept
+{
+   const auto frame_end =
+      Clock::now();
+
+   last_frame_cost_ =
+      frame_end - frame_start_;
+
+   // hold on to the peak cost and let it decay slowly, so a
+   // single cheap frame does not cause the next one to be late
+   frame_cost_estimate_ =
+      std::max(
+         last_frame_cost_,
+         frame_cost_estimate_ - frame_cost_estimate_ / 32);
+
+   ++frames_;
+
+   if (frame_period_ != Clock::duration::zero())
+   {
+      if (frame_end > deadline_)
+      {
+         ++missed_deadlines_;
+
+         // drop the missed frame slots instead of
+         // rendering back to back to catch up
+         deadline_ +=
+            ((frame_end - deadline_) / frame_period_ + 1) *
+            frame_period_;
+      }
+      else
+      {
+         deadline_ += frame_period_;
+      }
+   }
+}
+
+FramePacer::Clock::duration FramePacer::LastFrameCost( ) const noexcept
+{
+   return last_frame_cost_;
+}
+
+uint64_t FramePacer::Frames( ) const noexcept
+{
+   return frames_;
+}
+
+uint64_t FramePacer::MissedDeadlines( ) const noexcept
+{
+   return missed_deadlines_;
+}
+
+void FramePacer::SleepUntil(
+   const Clock::time_point time ) noexcept
+{
+   const auto sleep_until =
+      time - SPIN_DURATION;
+
+   if (Clock::now() < sleep_until)
+   {
+      std::this_thread::sleep_until(
+         sleep_until);
+   }
+
+   while (Clock::now() < time)
+   {
+      std::this_thread::yield();
+   }
+}
@@ -0,0 +1,50 @@
+#ifndef _FRAME_PACER_H_
+#define _FRAME_PACER_H_
+
+#include <chrono>
+#include <cstdint>
+
+// paces frames against absolute deadlines so that oversleeping
+// in one frame does not push out every frame that follows.  the
+// wait sleeps coarsely and then spins for the final stretch.
+class FramePacer final
+{
+public:
+   using Clock = std::chrono::steady_clock;
+
+   FramePacer( ) noexcept;
+
+   // a frame rate of zero disables pacing
+   void SetTargetFrameRate(
+      const double frames_per_second ) noexcept;
+   // when enabled the frame starts as late as the measured frame
+   // cost allows, which minimizes input to presentation latency
+   void SetRenderLate(
+      const bool render_late ) noexcept;
+
+   void BeginFrame( ) noexcept;
+   void EndFrame( ) noexcept;
+
+   Clock::duration LastFrameCost( ) const noexcept;
+   uint64_t Frames( ) const noexcept;
+   uint64_t MissedDeadlines( ) const noexcept;
+
+private:
+   static void SleepUntil(
+      const Clock::time_point time ) noexcept;
+
+   Clock::duration frame_period_;
+   bool render_late_;
+
+   Clock::time_point deadline_;
+   Clock::time_point frame_start_;
+
+   Clock::duration last_frame_cost_;
+   Clock::duration frame_cost_estimate_;
+
+   uint64_t frames_;
+   uint64_t missed_deadlines_;
+
+};
+
+#endif // _FRAME_PACER_H_
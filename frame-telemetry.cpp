@@ -0,0 +1,751 @@
+#include "frame-telemetry.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace telemetry
+{
+
+static const size_t PHASE_COUNT {
+   static_cast< size_t >(Phase::COUNT) };
+static const size_t EVENT_COUNT {
+   static_cast< size_t >(Event::COUNT) };
+
+// events waiting for the next dump.  older ones are discarded
+// when nothing dumps them.
+static const size_t MAXIMUM_LOGGED_EVENTS { 1024 };
+
+struct Sample
+{
+   const void * source;
+   Phase phase;
+   uint64_t duration_ns;
+};
+
+struct EventSample
+{
+   const void * source;
+   Event event;
+   double first_value;
+   double second_value;
+};
+
+// single producer single consumer ring.  the producer is the
+// recording thread and the consumer is the collector thread.
+// the producer retires the ring when its thread exits, and the
+// consumer releases it once it drained what was pushed before.
+template < typename T, size_t CAPACITY >
+class Ring final
+{
+public:
+   static_assert(
+      (CAPACITY & (CAPACITY - 1)) == 0,
+      "The capacity must be a power of two!");
+
+   bool Push(
+      const T & item ) noexcept
+   {
+      const auto head =
+         head_.load(std::memory_order_relaxed);
+
+      const bool pushed =
+         head - tail_.load(std::memory_order_acquire) < CAPACITY;
+
+      if (pushed)
+      {
+         items_[head & (CAPACITY - 1)] = item;
+
+         head_.store(
+            head + 1,
+            std::memory_order_release);
+      }
+
+      return pushed;
+   }
+
+   bool Pop(
+      T & item ) noexcept
+   {
+      const auto tail =
+         tail_.load(std::memory_order_relaxed);
+
+      const bool popped =
+         tail != head_.load(std::memory_order_acquire);
+
+      if (popped)
+      {
+         item = items_[tail & (CAPACITY - 1)];
+
+         tail_.store(
+            tail + 1,
+            std::memory_order_release);
+      }
+
+      return popped;
+   }
+
+   void Retire( ) noexcept
+   {
+      retired_.store(
+         true,
+         std::memory_order_release);
+   }
+
+   bool Retired( ) const noexcept
+   {
+      return
+         retired_.load(
+            std::memory_order_acquire);
+   }
+
+private:
+   std::array< T, CAPACITY > items_;
+
+   std::atomic< size_t > head_ { 0 };
+   std::atomic< size_t > tail_ { 0 };
+
+   std::atomic_bool retired_ { false };
+
+};
+
+using SampleRing =
+   Ring< Sample, 4096 >;
+// events are rare, so their rings are much smaller
+using EventRing =
+   Ring< EventSample, 64 >;
+
+class SampleWindow final
+{
+public:
+   void Add(
+      const uint64_t duration_ns ) noexcept
+   {
+      durations_ns_[next_] = duration_ns;
+
+      next_ = (next_ + 1) % CAPACITY;
+      count_ = std::min(count_ + 1, CAPACITY);
+   }
+
+   PhaseStatistics Statistics( ) const
+   {
+      PhaseStatistics statistics;
+
+      statistics.samples = count_;
+
+      if (count_)
+      {
+         std::vector< uint64_t > durations_ns {
+            durations_ns_.cbegin(),
+            durations_ns_.cbegin() + count_ };
+
+         const auto percentile =
+            [ & durations_ns ] ( const size_t percent )
+            {
+               const auto nth =
+                  durations_ns.begin() +
+                  (durations_ns.size() - 1) * percent / 100;
+
+               std::nth_element(
+                  durations_ns.begin(),
+                  nth,
+                  durations_ns.end());
+
+               return
+                  std::chrono::microseconds {
+                     static_cast< int64_t >(*nth / 1000) };
+            };
+
+         statistics.p50 = percentile(50);
+         statistics.p95 = percentile(95);
+         statistics.p99 = percentile(99);
+         statistics.max = percentile(100);
+      }
+
+      return statistics;
+   }
+
+private:
+   static constexpr size_t CAPACITY { 1024 };
+
+   std::array< uint64_t, CAPACITY > durations_ns_;
+
+   size_t next_ { 0 };
+   size_t count_ { 0 };
+
+};
+
+using SampleWindows =
+   std::array< SampleWindow, PHASE_COUNT >;
+
+static std::vector<
+   std::shared_ptr< SampleRing > > sample_rings_;
+static std::mutex sample_rings_mutex_;
+
+static std::vector<
+   std::shared_ptr< EventRing > > event_rings_;
+static std::mutex event_rings_mutex_;
+
+// the rings of a recording thread are retired when the thread exits
+struct ThreadRings
+{
+   ~ThreadRings( ) noexcept
+   {
+      if (sample_ring)
+      {
+         sample_ring->Retire();
+      }
+
+      if (event_ring)
+      {
+         event_ring->Retire();
+      }
+   }
+
+   std::shared_ptr< SampleRing > sample_ring;
+   std::shared_ptr< EventRing > event_ring;
+};
+
+static thread_local ThreadRings thread_rings_;
+
+static SampleWindows phase_windows_;
+static std::map< const void *, SampleWindows > source_windows_;
+static std::array< uint64_t, EVENT_COUNT > event_counts_ { };
+static std::deque< EventSample > logged_events_;
+static std::mutex windows_mutex_;
+
+static std::atomic< uint64_t > dropped_samples_ { 0 };
+
+static std::thread collector_thread_;
+static std::mutex collector_mutex_;
+static std::condition_variable collector_condition_;
+static bool quit_collector_ { false };
+
+// removes the rings in the list that were retired
+template < typename RingPointer >
+static void ReleaseRings(
+   std::vector< RingPointer > & rings,
+   std::mutex & rings_mutex,
+   const std::vector< RingPointer > & retired_rings )
+{
+   if (!retired_rings.empty())
+   {
+#if _has_cxx_class_template_argument_deduction
+      std::lock_guard lock {
+         rings_mutex };
+#else
+      std::lock_guard< std::mutex > lock {
+         rings_mutex };
+#endif
+
+      rings.erase(
+         std::remove_if(
+            rings.begin(),
+            rings.end(),
+            [ & retired_rings ] ( const RingPointer & ring )
+            {
+               return
+                  std::find(
+                     retired_rings.cbegin(),
+                     retired_rings.cend(),
+                     ring) != retired_rings.cend();
+            }),
+         rings.end());
+   }
+}
+
+// the samples of a removed source still in the rings are drained
+// before its windows are erased, so they do not add them again
+static void Collect(
+   const void * const removed_source = nullptr )
+{
+   std::vector<
+      std::shared_ptr< SampleRing > > sample_rings;
+
+   {
+#if _has_cxx_class_template_argument_deduction
+      std::lock_guard lock {
+         sample_rings_mutex_ };
+#else
+      std::lock_guard< decltype(sample_rings_mutex_) > lock {
+         sample_rings_mutex_ };
+#endif
+
+      sample_rings = sample_rings_;
+   }
+
+   std::vector<
+      std::shared_ptr< EventRing > > event_rings;
+
+   {
+#if _has_cxx_class_template_argument_deduction
+      std::lock_guard lock {
+         event_rings_mutex_ };
+#else
+      std::lock_guard< decltype(event_rings_mutex_) > lock {
+         event_rings_mutex_ };
+#endif
+
+      event_rings = event_rings_;
+   }
+
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      windows_mutex_ };
+#else
+   std::lock_guard< decltype(windows_mutex_) > lock {
+      windows_mutex_ };
+#endif
+
+   std::vector<
+      std::shared_ptr< SampleRing > > retired_sample_rings;
+
+   for (const auto & sample_ring : sample_rings)
+   {
+      // a ring retired before it is drained holds no more samples
+      // once drained, as its thread has exited
+      if (sample_ring->Retired())
+      {
+         retired_sample_rings.emplace_back(
+            sample_ring);
+      }
+
+      Sample sample;
+
+      while (sample_ring->Pop(sample))
+      {
+         const auto phase =
+            static_cast< size_t >(sample.phase);
+
+         phase_windows_[phase].Add(
+            sample.duration_ns);
+
+         if (sample.source)
+         {
+            source_windows_[sample.source][phase].Add(
+               sample.duration_ns);
+         }
+      }
+   }
+
+   std::vector<
+      std::shared_ptr< EventRing > > retired_event_rings;
+
+   for (const auto & event_ring : event_rings)
+   {
+      if (event_ring->Retired())
+      {
+         retired_event_rings.emplace_back(
+            event_ring);
+      }
+
+      EventSample event;
+
+      while (event_ring->Pop(event))
+      {
+         ++event_counts_[static_cast< size_t >(event.event)];
+
+         if (logged_events_.size() == MAXIMUM_LOGGED_EVENTS)
+         {
+            logged_events_.pop_front();
+         }
+
+         logged_events_.push_back(
+            event);
+      }
+   }
+
+   if (removed_source)
+   {
+      source_windows_.erase(
+         removed_source);
+   }
+
+   ReleaseRings(
+      sample_rings_,
+      sample_rings_mutex_,
+      retired_sample_rings);
+   ReleaseRings(
+      event_rings_,
+      event_rings_mutex_,
+      retired_event_rings);
+}
+
+static void WriteEvent(
+   const EventSample & event )
+{
+   std::cout
+      << EventName(event.event);
+
+   if (event.source)
+   {
+      std::cout
+         << " " << event.source;
+   }
+
+   switch (event.event)
+   {
+   case Event::RENDER_TARGET_CREATED:
+   case Event::RENDER_TARGET_FREED:
+      std::cout
+         << " " << event.first_value / (1024.0 * 1024.0)
+         << " MB, " << event.second_value / (1024.0 * 1024.0)
+         << " MB allocated\n";
+
+      break;
+
+   case Event::MULTISAMPLE_CHANGED:
+      std::cout
+         << " " << event.first_value
+         << " -> " << event.second_value
+         << " samples\n";
+
+      break;
+
+   case Event::RENDER_SCALE_CHANGED:
+      std::cout
+         << " " << event.first_value
+         << " -> " << event.second_value
+         << " scale\n";
+
+      break;
+
+   default:
+      std::cout
+         << " " << event.first_value
+         << " " << event.second_value
+         << "\n";
+
+      break;
+   }
+}
+
+static void Dump( )
+{
+   for (size_t phase { 0 }; phase < PHASE_COUNT; ++phase)
+   {
+      const auto statistics =
+         GetPhaseStatistics(
+            static_cast< Phase >(phase));
+
+      if (statistics.samples)
+      {
+         std::cout
+            << PhaseName(static_cast< Phase >(phase))
+            << " p50 " << statistics.p50.count()
+            << " us p95 " << statistics.p95.count()
+            << " us p99 " << statistics.p99.count()
+            << " us max " << statistics.max.count()
+            << " us\n";
+      }
+   }
+
+   std::deque< EventSample > events;
+
+   {
+#if _has_cxx_class_template_argument_deduction
+      std::lock_guard lock {
+         windows_mutex_ };
+#else
+      std::lock_guard< decltype(windows_mutex_) > lock {
+         windows_mutex_ };
+#endif
+
+      events.swap(
+         logged_events_);
+   }
+
+   for (const auto & event : events)
+   {
+      WriteEvent(
+         event);
+   }
+
+   std::cout
+      << "dropped samples "
+      << DroppedSamples()
+      << std::endl;
+}
+
+static void CollectorLoop(
+   const std::chrono::milliseconds dump_period )
+{
+   const std::chrono::milliseconds collect_period { 50 };
+
+   auto next_dump =
+      std::chrono::steady_clock::now() + dump_period;
+
+   std::unique_lock< std::mutex > lock {
+      collector_mutex_ };
+
+   while (!collector_condition_.wait_for(
+            lock,
+            collect_period,
+            [ ] ( ) { return quit_collector_; }))
+   {
+      lock.unlock();
+
+      Collect();
+
+      if (dump_period != std::chrono::milliseconds::zero() &&
+          std::chrono::steady_clock::now() >= next_dump)
+      {
+         Dump();
+
+         next_dump += dump_period;
+      }
+
+      lock.lock();
+   }
+}
+
+void Start(
+   const std::chrono::milliseconds dump_period ) noexcept
+{
+   if (collector_thread_.get_id() == std::thread::id { })
+   {
+      quit_collector_ = false;
+
+      collector_thread_ =
+         std::thread {
+            &CollectorLoop,
+            dump_period };
+   }
+}
+
+void Stop( ) noexcept
+{
+   if (collector_thread_.get_id() != std::thread::id { })
+   {
+      {
+#if _has_cxx_class_template_argument_deduction
+         std::lock_guard lock {
+            collector_mutex_ };
+#else
+         std::lock_guard< decltype(collector_mutex_) > lock {
+            collector_mutex_ };
+#endif
+
+         quit_collector_ = true;
+      }
+
+      collector_condition_.notify_one();
+
+      collector_thread_.join();
+   }
+}
+
+void Record(
+   const Phase phase,
+   const std::chrono::steady_clock::duration duration,
+   const void * const source ) noexcept
+{
+   auto & thread_sample_ring =
+      thread_rings_.sample_ring;
+
+   if (!thread_sample_ring)
+   {
+      // registration only happens once per recording thread
+      thread_sample_ring =
+         std::make_shared< SampleRing >();
+
+#if _has_cxx_class_template_argument_deduction
+      std::lock_guard lock {
+         sample_rings_mutex_ };
+#else
+      std::lock_guard< decltype(sample_rings_mutex_) > lock {
+         sample_rings_mutex_ };
+#endif
+
+      sample_rings_.emplace_back(
+         thread_sample_ring);
+   }
+
+   const Sample sample {
+      source,
+      phase,
+      static_cast< uint64_t >(
+         std::chrono::duration_cast< std::chrono::nanoseconds >(
+            duration).count()) };
+
+   if (!thread_sample_ring->Push(sample))
+   {
+      dropped_samples_.fetch_add(
+         1,
+         std::memory_order_relaxed);
+   }
+}
+
+void RecordEvent(
+   const Event event,
+   const double first_value,
+   const double second_value,
+   const void * const source ) noexcept
+{
+   auto & thread_event_ring =
+      thread_rings_.event_ring;
+
+   if (!thread_event_ring)
+   {
+      thread_event_ring =
+         std::make_shared< EventRing >();
+
+#if _has_cxx_class_template_argument_deduction
+      std::lock_guard lock {
+         event_rings_mutex_ };
+#else
+      std::lock_guard< decltype(event_rings_mutex_) > lock {
+         event_rings_mutex_ };
+#endif
+
+      event_rings_.emplace_back(
+         thread_event_ring);
+   }
+
+   const EventSample event_sample {
+      source,
+      event,
+      first_value,
+      second_value };
+
+   if (!thread_event_ring->Push(event_sample))
+   {
+      dropped_samples_.fetch_add(
+         1,
+         std::memory_order_relaxed);
+   }
+}
+
+PhaseStatistics GetPhaseStatistics(
+   const Phase phase ) noexcept
+{
+   Collect();
+
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      windows_mutex_ };
+#else
+   std::lock_guard< decltype(windows_mutex_) > lock {
+      windows_mutex_ };
+#endif
+
+   return
+      phase < Phase::COUNT ?
+      phase_windows_[static_cast< size_t >(phase)].Statistics() :
+      PhaseStatistics { };
+}
+
+PhaseStatistics GetPhaseStatistics(
+   const Phase phase,
+   const void * const source ) noexcept
+{
+   Collect();
+
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      windows_mutex_ };
+#else
+   std::lock_guard< decltype(windows_mutex_) > lock {
+      windows_mutex_ };
+#endif
+
+   const auto source_windows =
+      source_windows_.find(
+         source);
+
+   return
+      phase < Phase::COUNT &&
+      source_windows != source_windows_.cend() ?
+      source_windows->second[static_cast< size_t >(phase)].Statistics() :
+      PhaseStatistics { };
+}
+
+uint64_t EventCount(
+   const Event event ) noexcept
+{
+   Collect();
+
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      windows_mutex_ };
+#else
+   std::lock_guard< decltype(windows_mutex_) > lock {
+      windows_mutex_ };
+#endif
+
+   return
+      event < Event::COUNT ?
+      event_counts_[static_cast< size_t >(event)] :
+      0;
+}
+
+uint64_t DroppedSamples( ) noexcept
+{
+   return
+      dropped_samples_.load(
+         std::memory_order_relaxed);
+}
+
+void RemoveSource(
+   const void * const source ) noexcept
+{
+   if (source)
+   {
+      Collect(
+         source);
+   }
+}
+
+const char * PhaseName(
+   const Phase phase ) noexcept
+{
+   static const char * const names[PHASE_COUNT] {
+      "frame",
+      "operations",
+      "process events",
+      "prepare stage",
+      "update stage",
+      "cull stage",
+      "draw stage",
+      "cull wait",
+      "view compile",
+      "view update",
+      "view cull",
+      "view draw",
+      "view fence",
+      "view gpu geometry",
+      "view gpu resolve",
+      "view gpu present"
+   };
+
+   return
+      phase < Phase::COUNT ?
+      names[static_cast< size_t >(phase)] :
+      "unknown";
+}
+
+const char * EventName(
+   const Event event ) noexcept
+{
+   static const char * const names[EVENT_COUNT] {
+      "render target created",
+      "render target freed",
+      "multisample changed",
+      "render scale changed"
+   };
+
+   return
+      event < Event::COUNT ?
+      names[static_cast< size_t >(event)] :
+      "unknown";
+}
+
+} // namespace telemetry
@@ -0,0 +1,106 @@
+#ifndef _FRAME_TELEMETRY_H_
+#define _FRAME_TELEMETRY_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace telemetry
+{
+
+enum class Phase
+{
+   FRAME,
+   OPERATIONS,
+   PROCESS_EVENTS,
+   PREPARE_STAGE,
+   UPDATE_STAGE,
+   CULL_STAGE,
+   DRAW_STAGE,
+   CULL_WAIT,
+   VIEW_COMPILE,
+   VIEW_UPDATE,
+   VIEW_CULL,
+   VIEW_DRAW,
+   VIEW_FENCE,
+   // gpu time, read back a few frames after it was recorded
+   VIEW_GPU_GEOMETRY,
+   VIEW_GPU_RESOLVE,
+   VIEW_GPU_PRESENT,
+   COUNT
+};
+
+// rare changes reported along with the phase timings.  an event
+// carries two values whose meaning depends on the event.
+enum class Event
+{
+   // the bytes of the render target and the bytes allocated by all
+   // render targets once it was created or freed
+   RENDER_TARGET_CREATED,
+   RENDER_TARGET_FREED,
+   // the sample count of a view before and after the change
+   MULTISAMPLE_CHANGED,
+   // the render scale of a view before and after the change
+   RENDER_SCALE_CHANGED,
+   COUNT
+};
+
+struct PhaseStatistics
+{
+   // samples in the rolling window
+   size_t samples { 0 };
+
+   std::chrono::microseconds p50 { 0 };
+   std::chrono::microseconds p95 { 0 };
+   std::chrono::microseconds p99 { 0 };
+   std::chrono::microseconds max { 0 };
+};
+
+// the collector drains the recorded samples into rolling windows.
+// a non zero dump period periodically writes the statistics of
+// every phase and the events recorded since the previous dump to
+// the standard output from the collector thread.
+void Start(
+   const std::chrono::milliseconds dump_period =
+      std::chrono::milliseconds::zero() ) noexcept;
+void Stop( ) noexcept;
+
+// lock free and without i/o, so it is safe to call from the render
+// threads.  the source identifies the view a sample belongs to.
+void Record(
+   const Phase phase,
+   const std::chrono::steady_clock::duration duration,
+   const void * const source = nullptr ) noexcept;
+// lock free and without i/o as well
+void RecordEvent(
+   const Event event,
+   const double first_value,
+   const double second_value,
+   const void * const source = nullptr ) noexcept;
+
+PhaseStatistics GetPhaseStatistics(
+   const Phase phase ) noexcept;
+PhaseStatistics GetPhaseStatistics(
+   const Phase phase,
+   const void * const source ) noexcept;
+// events recorded since the collector started
+uint64_t EventCount(
+   const Event event ) noexcept;
+// samples and events that could not be recorded
+// because the collector fell behind
+uint64_t DroppedSamples( ) noexcept;
+
+// collects the samples of the source recorded so far and discards
+// them along with its statistics.  the source must not record any
+// more samples, as those would start its statistics over.
+void RemoveSource(
+   const void * const source ) noexcept;
+
+const char * PhaseName(
+   const Phase phase ) noexcept;
+const char * EventName(
+   const Event event ) noexcept;
+
+} // namespace telemetry
+
+#endif // _FRAME_TELEMETRY_H_
@@ -12,8 +12,10 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdint>
+#include <mutex>
 
 #define GL_SYNC_CONDITION                 0x9113
 #define GL_SYNC_STATUS                    0x9114
@@ -22,6 +24,11 @@
 #define GL_SYNC_GPU_COMMANDS_COMPLETE     0x9117
 #define GL_UNSIGNALED                     0x9118
 #define GL_SIGNALED                       0x9119
+#define GL_ALREADY_SIGNALED               0x911A
+#define GL_TIMEOUT_EXPIRED                0x911B
+#define GL_CONDITION_SATISFIED            0x911C
+#define GL_WAIT_FAILED                    0x911D
+#define GL_TIMEOUT_IGNORED                0xFFFFFFFFFFFFFFFFull
 
 namespace gl
 {
@@ -61,44 +68,61 @@ GetProcAddress( const char * const function )
 
 } // namespace ext
 
+static std::atomic_bool extensions_setup_ { false };
+static std::mutex extensions_setup_mutex_;
+
 static bool SetupExtensions( )
 {
+   if (!extensions_setup_.load(std::memory_order_acquire))
+   {
 #if _WIN32
-   assert(wglGetCurrentContext());
+      assert(wglGetCurrentContext());
 #elif __linux__
-   assert(glXGetCurrentContext());
+      assert(glXGetCurrentContext());
 #else
 #error "Define for this platform!"
 #endif
-   
-   if (!ext::glFenceSync || !ext::glIsSync ||
-       !ext::glDeleteSync || !ext::glClientWaitSync ||
-       !ext::glWaitSync || !ext::glGetSynciv)
-   {
-      ext::glFenceSync =
-         reinterpret_cast< decltype(ext::glFenceSync) >(
-            ext::GetProcAddress("glFenceSync"));
-      ext::glIsSync =
-         reinterpret_cast< decltype(ext::glIsSync) >(
-            ext::GetProcAddress("glIsSync"));
-      ext::glDeleteSync =
-         reinterpret_cast< decltype(ext::glDeleteSync) >(
-            ext::GetProcAddress("glDeleteSync"));
-      ext::glClientWaitSync =
-         reinterpret_cast< decltype(ext::glClientWaitSync) >(
-            ext::GetProcAddress("glClientWaitSync"));
-      ext::glWaitSync =
-         reinterpret_cast< decltype(ext::glWaitSync) >(
-            ext::GetProcAddress("glWaitSync"));
-      ext::glGetSynciv =
-         reinterpret_cast< decltype(ext::glGetSynciv) >(
-            ext::GetProcAddress("glGetSynciv"));
+
+#if _has_cxx_class_template_argument_deduction
+      std::lock_guard lock {
+         extensions_setup_mutex_ };
+#else
+      std::lock_guard< decltype(extensions_setup_mutex_) > lock {
+         extensions_setup_mutex_ };
+#endif
+
+      if (!extensions_setup_)
+      {
+         ext::glFenceSync =
+            reinterpret_cast< decltype(ext::glFenceSync) >(
+               ext::GetProcAddress("glFenceSync"));
+         ext::glIsSync =
+            reinterpret_cast< decltype(ext::glIsSync) >(
+               ext::GetProcAddress("glIsSync"));
+         ext::glDeleteSync =
+            reinterpret_cast< decltype(ext::glDeleteSync) >(
+               ext::GetProcAddress("glDeleteSync"));
+         ext::glClientWaitSync =
+            reinterpret_cast< decltype(ext::glClientWaitSync) >(
+               ext::GetProcAddress("glClientWaitSync"));
+         ext::glWaitSync =
+            reinterpret_cast< decltype(ext::glWaitSync) >(
+               ext::GetProcAddress("glWaitSync"));
+         ext::glGetSynciv =
+            reinterpret_cast< decltype(ext::glGetSynciv) >(
+               ext::GetProcAddress("glGetSynciv"));
+
+         extensions_setup_.store(
+            ext::glFenceSync && ext::glIsSync &&
+            ext::glDeleteSync && ext::glClientWaitSync &&
+            ext::glWaitSync && ext::glGetSynciv,
+            std::memory_order_release);
+      }
    }
 
    return
-      ext::glFenceSync && ext::glIsSync &&
-      ext::glDeleteSync && ext::glClientWaitSync &&
-      ext::glWaitSync && ext::glGetSynciv;
+      extensions_setup_.load(
+         std::memory_order_relaxed);
 }
 
 static void * CreateFenceSync( )
@@ -123,16 +147,16 @@ fence_sync_ { CreateFenceSync() }
 
 FenceSync::~FenceSync( ) noexcept
 {
+   if (fence_sync_)
+   {
 #if _WIN32
-   assert(wglGetCurrentContext());
+      assert(wglGetCurrentContext());
 #elif __linux__
-   assert(glXGetCurrentContext());
+      assert(glXGetCurrentContext());
 #else
 #error "Define for this platform!"
 #endif
 
-   if (fence_sync_)
-   {
       ext::glDeleteSync(
          fence_sync_);
    }
@@ -143,8 +167,8 @@ FenceSync::FenceSync(
 fence_sync_ { nullptr }
 {
    std::swap(
-      const_cast< ext::GLsync & >(fence_sync_),
-      const_cast< ext::GLsync & >(o.fence_sync_));
+      fence_sync_,
+      o.fence_sync_);
 }
 
 FenceSync & FenceSync::operator = (
@@ -153,8 +177,8 @@ FenceSync & FenceSync::operator = (
    if (&o != this)
    {
       std::swap(
-         const_cast< ext::GLsync & >(fence_sync_),
-         const_cast< ext::GLsync & >(o.fence_sync_));
+         fence_sync_,
+         o.fence_sync_);
    }
 
    return *this;
@@ -199,4 +223,55 @@ bool FenceSync::IsSignaled( ) const noexcept
    return signaled;
 }
 
+bool FenceSync::ClientWait(
+   const std::chrono::nanoseconds timeout ) const noexcept
+{
+#if _WIN32
+   assert(wglGetCurrentContext());
+#elif __linux__
+   assert(glXGetCurrentContext());
+#else
+#error "Define for this platform!"
+#endif
+
+   bool signaled { false };
+
+   if (Valid())
+   {
+      const auto result =
+         ext::glClientWaitSync(
+            fence_sync_,
+            0,
+            static_cast< ext::GLuint64 >(
+               std::max(
+                  timeout,
+                  std::chrono::nanoseconds::zero()).count()));
+
+      signaled =
+         result == GL_ALREADY_SIGNALED ||
+         result == GL_CONDITION_SATISFIED;
+   }
+
+   return signaled;
+}
+
+void FenceSync::WaitOnServer( ) const noexcept
+{
+#if _WIN32
+   assert(wglGetCurrentContext());
+#elif __linux__
+   assert(glXGetCurrentContext());
+#else
+#error "Define for this platform!"
+#endif
+
+   if (Valid())
+   {
+      ext::glWaitSync(
+         fence_sync_,
+         0,
+         GL_TIMEOUT_IGNORED);
+   }
+}
+
 } // namespace gl
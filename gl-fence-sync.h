@@ -1,9 +1,13 @@
 #ifndef _GL_FENCE_SYNC_H_
 #define _GL_FENCE_SYNC_H_
 
+#include <chrono>
+
 namespace gl
 {
 
+// the sync object is deleted with the fence, which requires a
+// current context on the thread destroying it
 class FenceSync final
 {
 public:
@@ -18,9 +22,17 @@ public:
 
    bool Valid( ) const noexcept;
    bool IsSignaled( ) const noexcept;
+   // blocks until the fence signals or the timeout expires and
+   // returns if the fence signaled.  any context sharing with the
+   // one that created the fence may wait on it.
+   bool ClientWait(
+      const std::chrono::nanoseconds timeout ) const noexcept;
+   // makes the gpu wait for the fence before executing any command
+   // issued afterwards on the current context.  returns immediately.
+   void WaitOnServer( ) const noexcept;
 
 private:
-   void * const fence_sync_;
+   void * fence_sync_;
 
 };
 
@@ -0,0 +1,185 @@
+#include "gl-invalidate-frame-buffer.h"
+
+#if _WIN32
+#elif __linux__
+#include <GL/glx.h>
+#else
+#error "Define for this platform!"
+#endif
+
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <mutex>
+
+#ifndef GL_MAJOR_VERSION
+#define GL_MAJOR_VERSION                  0x821B
+#endif
+#ifndef GL_MINOR_VERSION
+#define GL_MINOR_VERSION                  0x821C
+#endif
+#ifndef GL_NUM_EXTENSIONS
+#define GL_NUM_EXTENSIONS                 0x821D
+#endif
+
+namespace gl
+{
+
+namespace ext
+{
+
+// core in gl 4.3 and otherwise provided by arb_invalidate_subdata.
+// ext_discard_framebuffer provides the same with another name.
+static void (APIENTRY *glInvalidateFramebuffer)(GLenum target, GLsizei numAttachments, const GLenum *attachments) { nullptr };
+static const GLubyte * (APIENTRY *glGetStringi)(GLenum name, GLuint index) { nullptr };
+
+#if _WIN32
+inline decltype(wglGetProcAddress(nullptr))
+GetProcAddress( const char * const function )
+{
+   return
+      wglGetProcAddress(function);
+}
+#elif __linux__
+inline decltype(glXGetProcAddress(nullptr))
+GetProcAddress( const char * const function )
+{
+   return
+      glXGetProcAddress(
+         reinterpret_cast< const GLubyte * >(function));
+}
+#else
+#error "Define for this platform!"
+#endif
+
+} // namespace ext
+
+static std::atomic_bool extensions_setup_ { false };
+static std::atomic_bool extensions_supported_ { false };
+static std::mutex extensions_setup_mutex_;
+
+static bool HasExtension(
+   const char * const extension )
+{
+   GLint extensions { 0 };
+
+   glGetIntegerv(
+      GL_NUM_EXTENSIONS,
+      &extensions);
+
+   bool has_extension { false };
+
+   for (GLint i { 0 }; !has_extension && i < extensions; ++i)
+   {
+      const auto name =
+         ext::glGetStringi(
+            GL_EXTENSIONS,
+            static_cast< GLuint >(i));
+
+      has_extension =
+         name &&
+         std::strcmp(
+            reinterpret_cast< const char * >(name),
+            extension) == 0;
+   }
+
+   return has_extension;
+}
+
+// the address of a function is returned for any name whether the
+// context supports it or not, so support is decided by the version
+// and the extensions of the context.  the render contexts are all
+// created alike, so the first one current decides for all of them.
+static bool SetupExtensions( )
+{
+   if (!extensions_setup_.load(std::memory_order_acquire))
+   {
+#if _has_cxx_class_template_argument_deduction
+      std::lock_guard lock {
+         extensions_setup_mutex_ };
+#else
+      std::lock_guard< decltype(extensions_setup_mutex_) > lock {
+         extensions_setup_mutex_ };
+#endif
+
+      if (!extensions_setup_)
+      {
+         GLint major_version { 0 };
+         GLint minor_version { 0 };
+
+         glGetIntegerv(
+            GL_MAJOR_VERSION,
+            &major_version);
+         glGetIntegerv(
+            GL_MINOR_VERSION,
+            &minor_version);
+
+         ext::glGetStringi =
+            reinterpret_cast< decltype(ext::glGetStringi) >(
+               ext::GetProcAddress("glGetStringi"));
+
+         const bool invalidate_frame_buffer {
+            major_version > 4 ||
+            (major_version == 4 && minor_version >= 3) ||
+            (ext::glGetStringi &&
+             HasExtension("GL_ARB_invalidate_subdata")) };
+         const bool discard_frame_buffer {
+            !invalidate_frame_buffer &&
+            ext::glGetStringi &&
+            HasExtension("GL_EXT_discard_framebuffer") };
+
+         if (invalidate_frame_buffer)
+         {
+            ext::glInvalidateFramebuffer =
+               reinterpret_cast< decltype(ext::glInvalidateFramebuffer) >(
+                  ext::GetProcAddress("glInvalidateFramebuffer"));
+         }
+         else if (discard_frame_buffer)
+         {
+            ext::glInvalidateFramebuffer =
+               reinterpret_cast< decltype(ext::glInvalidateFramebuffer) >(
+                  ext::GetProcAddress("glDiscardFramebufferEXT"));
+         }
+
+         extensions_supported_.store(
+            ext::glInvalidateFramebuffer != nullptr,
+            std::memory_order_relaxed);
+         extensions_setup_.store(
+            true,
+            std::memory_order_release);
+      }
+   }
+
+   return
+      extensions_supported_.load(
+         std::memory_order_relaxed);
+}
+
+bool InvalidateFrameBuffer(
+   const GLenum target,
+   const GLenum * const attachments,
+   const GLsizei count ) noexcept
+{
+#if _WIN32
+   assert(wglGetCurrentContext());
+#elif __linux__
+   assert(glXGetCurrentContext());
+#else
+#error "Define for this platform!"
+#endif
+
+   const bool supported {
+      SetupExtensions() };
+
+   if (supported && count)
+   {
+      ext::glInvalidateFramebuffer(
+         target,
+         count,
+         attachments);
+   }
+
+   return supported;
+}
+
+} // namespace gl
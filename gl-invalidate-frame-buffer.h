@@ -0,0 +1,45 @@
+#ifndef _GL_INVALIDATE_FRAME_BUFFER_H_
+#define _GL_INVALIDATE_FRAME_BUFFER_H_
+
+#if _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <GL/GL.h>
+#elif __linux__
+#include <GL/gl.h>
+#else
+#error "Define for this platform!"
+#endif
+
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER                    0x8D40
+#endif
+#ifndef GL_COLOR_ATTACHMENT0
+#define GL_COLOR_ATTACHMENT0              0x8CE0
+#endif
+#ifndef GL_DEPTH_ATTACHMENT
+#define GL_DEPTH_ATTACHMENT               0x8D00
+#endif
+#ifndef GL_STENCIL_ATTACHMENT
+#define GL_STENCIL_ATTACHMENT             0x8D20
+#endif
+#ifndef GL_DEPTH_STENCIL_ATTACHMENT
+#define GL_DEPTH_STENCIL_ATTACHMENT       0x821A
+#endif
+
+namespace gl
+{
+
+// tells the driver the contents of the attachments of the frame
+// buffer bound to the target are no longer needed, so they are
+// neither loaded before nor stored after the commands that follow.
+// returns false and does nothing when the context supports neither
+// gl 4.3, arb_invalidate_subdata nor ext_discard_framebuffer.
+bool InvalidateFrameBuffer(
+   const GLenum target,
+   const GLenum * const attachments,
+   const GLsizei count ) noexcept;
+
+} // namespace gl
+
+#endif // _GL_INVALIDATE_FRAME_BUFFER_H_
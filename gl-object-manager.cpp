@@ -0,0 +1,43 @@
+#include "gl-object-manager.h"
+
+#include <atomic>
+
+namespace gl_objects
+{
+
+static const unsigned int INVALID_CONTEXT_ID {
+   static_cast< unsigned int >(-1) };
+
+static std::atomic< unsigned int > shared_context_id_ {
+   INVALID_CONTEXT_ID };
+static std::mutex shared_context_id_mutex_;
+
+void SetSharedContextID(
+   const unsigned int context_id ) noexcept
+{
+   shared_context_id_ = context_id;
+}
+
+void ReleaseSharedContextID( ) noexcept
+{
+   shared_context_id_ = INVALID_CONTEXT_ID;
+}
+
+bool IsSharedContextID(
+   const unsigned int context_id ) noexcept
+{
+   return
+      context_id != INVALID_CONTEXT_ID &&
+      context_id == shared_context_id_;
+}
+
+std::unique_lock< std::mutex > Lock(
+   const unsigned int context_id ) noexcept
+{
+   return
+      IsSharedContextID(context_id) ?
+      std::unique_lock< std::mutex > { shared_context_id_mutex_ } :
+      std::unique_lock< std::mutex > { };
+}
+
+} // namespace gl_objects
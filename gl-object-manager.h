@@ -0,0 +1,32 @@
+#ifndef _GL_OBJECT_MANAGER_H_
+#define _GL_OBJECT_MANAGER_H_
+
+#include <mutex>
+
+namespace gl_objects
+{
+
+// osg keeps one set of gl object managers per context id.  when
+// the contexts sharing with the hidden context share its context
+// id, every texture, buffer and program is compiled only once, but
+// the managers are then used by several threads.  all compiling,
+// drawing and deleting of gl objects for the shared context id
+// must happen while holding the lock returned below, which leaves
+// the render threads drawing one after the other.  the id is shared
+// when a single render thread is started.  with several render
+// threads every context has an id of its own and the lock is never
+// taken.
+void SetSharedContextID(
+   const unsigned int context_id ) noexcept;
+void ReleaseSharedContextID( ) noexcept;
+bool IsSharedContextID(
+   const unsigned int context_id ) noexcept;
+
+// the returned lock does not own a mutex when the context id is
+// not shared, so contexts with their own id never wait
+std::unique_lock< std::mutex > Lock(
+   const unsigned int context_id ) noexcept;
+
+} // namespace gl_objects
+
+#endif // _GL_OBJECT_MANAGER_H_
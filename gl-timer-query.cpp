@@ -0,0 +1,284 @@
+#include "gl-timer-query.h"
+
+#if _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <GL/GL.h>
+#elif __linux__
+#include <GL/gl.h>
+#include <GL/glx.h>
+#else
+#error "Define for this platform!"
+#endif
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <mutex>
+
+#define GL_QUERY_COUNTER_BITS             0x8864
+#define GL_QUERY_RESULT                   0x8866
+#define GL_QUERY_RESULT_AVAILABLE         0x8867
+#define GL_TIMESTAMP                      0x8E28
+
+namespace gl
+{
+
+namespace ext
+{
+
+using GLuint64 = uint64_t;
+
+static void (APIENTRY *glGenQueries)(GLsizei n, GLuint *ids) { nullptr };
+static void (APIENTRY *glDeleteQueries)(GLsizei n, const GLuint *ids) { nullptr };
+static void (APIENTRY *glQueryCounter)(GLuint id, GLenum target) { nullptr };
+static void (APIENTRY *glGetQueryiv)(GLenum target, GLenum pname, GLint *params) { nullptr };
+static void (APIENTRY *glGetQueryObjectiv)(GLuint id, GLenum pname, GLint *params) { nullptr };
+static void (APIENTRY *glGetQueryObjectui64v)(GLuint id, GLenum pname, GLuint64 *params) { nullptr };
+
+#if _WIN32
+inline decltype(wglGetProcAddress(nullptr))
+GetProcAddress( const char * const function )
+{
+   return
+      wglGetProcAddress(function);
+}
+#elif __linux__
+inline decltype(glXGetProcAddress(nullptr))
+GetProcAddress( const char * const function )
+{
+   return
+      glXGetProcAddress(
+         reinterpret_cast< const GLubyte * >(function));
+}
+#else
+#error "Define for this platform!"
+#endif
+
+} // namespace ext
+
+static std::atomic_bool extensions_setup_ { false };
+static std::mutex extensions_setup_mutex_;
+
+static bool SetupExtensions( )
+{
+   if (!extensions_setup_.load(std::memory_order_acquire))
+   {
+#if _has_cxx_class_template_argument_deduction
+      std::lock_guard lock {
+         extensions_setup_mutex_ };
+#else
+      std::lock_guard< decltype(extensions_setup_mutex_) > lock {
+         extensions_setup_mutex_ };
+#endif
+
+      if (!extensions_setup_)
+      {
+         ext::glGenQueries =
+            reinterpret_cast< decltype(ext::glGenQueries) >(
+               ext::GetProcAddress("glGenQueries"));
+         ext::glDeleteQueries =
+            reinterpret_cast< decltype(ext::glDeleteQueries) >(
+               ext::GetProcAddress("glDeleteQueries"));
+         ext::glQueryCounter =
+            reinterpret_cast< decltype(ext::glQueryCounter) >(
+               ext::GetProcAddress("glQueryCounter"));
+         ext::glGetQueryiv =
+            reinterpret_cast< decltype(ext::glGetQueryiv) >(
+               ext::GetProcAddress("glGetQueryiv"));
+         ext::glGetQueryObjectiv =
+            reinterpret_cast< decltype(ext::glGetQueryObjectiv) >(
+               ext::GetProcAddress("glGetQueryObjectiv"));
+         ext::glGetQueryObjectui64v =
+            reinterpret_cast< decltype(ext::glGetQueryObjectui64v) >(
+               ext::GetProcAddress("glGetQueryObjectui64v"));
+
+         extensions_setup_.store(
+            ext::glGenQueries && ext::glDeleteQueries &&
+            ext::glQueryCounter && ext::glGetQueryiv &&
+            ext::glGetQueryObjectiv && ext::glGetQueryObjectui64v,
+            std::memory_order_release);
+      }
+   }
+
+   return
+      extensions_setup_.load(
+         std::memory_order_relaxed);
+}
+
+TimerQuery::TimerQuery(
+   const size_t marks,
+   const size_t latency ) noexcept :
+marks_ { marks },
+latency_ { latency },
+oldest_frame_ { 0 },
+frames_in_flight_ { 0 },
+recording_ { false },
+next_mark_ { 0 }
+{
+   assert(marks_ && latency_);
+}
+
+TimerQuery::~TimerQuery( ) noexcept
+{
+   Release();
+}
+
+bool TimerQuery::CreateQueries( ) noexcept
+{
+#if _WIN32
+   assert(wglGetCurrentContext());
+#elif __linux__
+   assert(glXGetCurrentContext());
+#else
+#error "Define for this platform!"
+#endif
+
+   if (queries_.empty() &&
+       SetupExtensions())
+   {
+      GLint counter_bits { 0 };
+
+      // an implementation may support the queries
+      // without any bits to hold the time stamps
+      ext::glGetQueryiv(
+         GL_TIMESTAMP,
+         GL_QUERY_COUNTER_BITS,
+         &counter_bits);
+
+      if (counter_bits)
+      {
+         queries_.resize(
+            marks_ * latency_);
+
+         ext::glGenQueries(
+            static_cast< GLsizei >(queries_.size()),
+            queries_.data());
+      }
+   }
+
+   return !queries_.empty();
+}
+
+bool TimerQuery::BeginFrame( ) noexcept
+{
+   recording_ =
+      CreateQueries() &&
+      frames_in_flight_ < latency_;
+
+   next_mark_ = 0;
+
+   return recording_;
+}
+
+void TimerQuery::Mark( ) noexcept
+{
+   if (recording_ &&
+       next_mark_ < marks_)
+   {
+      const auto frame =
+         (oldest_frame_ + frames_in_flight_) % latency_;
+
+      ext::glQueryCounter(
+         queries_[frame * marks_ + next_mark_],
+         GL_TIMESTAMP);
+
+      ++next_mark_;
+   }
+}
+
+void TimerQuery::EndFrame( ) noexcept
+{
+   // the results of a query that was never issued cannot be read
+   if (recording_ &&
+       next_mark_ == marks_)
+   {
+      ++frames_in_flight_;
+   }
+
+   recording_ = false;
+}
+
+bool TimerQuery::Intervals(
+   std::vector< std::chrono::nanoseconds > & intervals ) noexcept
+{
+   bool available { false };
+
+   if (frames_in_flight_)
+   {
+      const auto frame_queries =
+         queries_.cbegin() + oldest_frame_ * marks_;
+
+      GLint result_available { GL_FALSE };
+
+      // the queries complete in the order they were issued,
+      // so the last mark is available only after all others
+      ext::glGetQueryObjectiv(
+         *(frame_queries + (marks_ - 1)),
+         GL_QUERY_RESULT_AVAILABLE,
+         &result_available);
+
+      available =
+         result_available == GL_TRUE;
+
+      if (available)
+      {
+         intervals.clear();
+
+         ext::GLuint64 previous_time_stamp { 0 };
+
+         for (size_t mark { 0 }; mark < marks_; ++mark)
+         {
+            ext::GLuint64 time_stamp { 0 };
+
+            ext::glGetQueryObjectui64v(
+               *(frame_queries + mark),
+               GL_QUERY_RESULT,
+               &time_stamp);
+
+            if (mark)
+            {
+               intervals.emplace_back(
+                  static_cast< int64_t >(
+                     time_stamp - previous_time_stamp));
+            }
+
+            previous_time_stamp = time_stamp;
+         }
+
+         oldest_frame_ =
+            (oldest_frame_ + 1) % latency_;
+
+         --frames_in_flight_;
+      }
+   }
+
+   return available;
+}
+
+void TimerQuery::Release( ) noexcept
+{
+   if (!queries_.empty())
+   {
+#if _WIN32
+      assert(wglGetCurrentContext());
+#elif __linux__
+      assert(glXGetCurrentContext());
+#else
+#error "Define for this platform!"
+#endif
+
+      ext::glDeleteQueries(
+         static_cast< GLsizei >(queries_.size()),
+         queries_.data());
+
+      queries_.clear();
+   }
+
+   oldest_frame_ = 0;
+   frames_in_flight_ = 0;
+   recording_ = false;
+   next_mark_ = 0;
+}
+
+} // namespace gl
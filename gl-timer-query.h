@@ -0,0 +1,70 @@
+#ifndef _GL_TIMER_QUERY_H_
+#define _GL_TIMER_QUERY_H_
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace gl
+{
+
+// gpu time stamps recorded at a fixed number of marks in a frame.
+// the results of a frame are read several frames later, so reading
+// them never stalls the pipeline.  query objects are not shared
+// between contexts, so the timer belongs to the context current when
+// the first frame is begun and must be released on that context.
+class TimerQuery final
+{
+public:
+   // latency is the number of frames that can be in flight before
+   // the oldest one must have its results available
+   TimerQuery(
+      const size_t marks,
+      const size_t latency = 4 ) noexcept;
+   ~TimerQuery( ) noexcept;
+
+   TimerQuery( TimerQuery && ) noexcept = delete;
+   TimerQuery( const TimerQuery & ) noexcept = delete;
+
+   TimerQuery & operator = ( TimerQuery && ) noexcept = delete;
+   TimerQuery & operator = ( const TimerQuery & ) noexcept = delete;
+
+   // returns if the frame is timed.  a frame is skipped when all the
+   // frames in flight are still waiting on their results.
+   bool BeginFrame( ) noexcept;
+   // records the time stamp of the next mark once the gpu has
+   // completed every command issued before it
+   void Mark( ) noexcept;
+   // a frame is only kept once every one of its marks was recorded
+   void EndFrame( ) noexcept;
+
+   // the gpu time in between consecutive marks of the oldest frame
+   // in flight.  returns false without blocking when the results of
+   // that frame are not available yet.
+   bool Intervals(
+      std::vector< std::chrono::nanoseconds > & intervals ) noexcept;
+
+   // deletes the query objects, which requires the context they
+   // were created on to be current
+   void Release( ) noexcept;
+
+private:
+   bool CreateQueries( ) noexcept;
+
+   const size_t marks_;
+   const size_t latency_;
+
+   std::vector< unsigned int > queries_;
+
+   // frames in flight start at the oldest one
+   size_t oldest_frame_;
+   size_t frames_in_flight_;
+
+   bool recording_;
+   size_t next_mark_;
+
+};
+
+} // namespace gl
+
+#endif // _GL_TIMER_QUERY_H_
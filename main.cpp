@@ -1,13 +1,19 @@
 #if _WIN32
 #include "qt-gl-view.h"
 #endif
+#include "fence-watcher.h"
+#include "frame-telemetry.h"
+#include "model-loader.h"
 #include "render-thread.h"
+#include "worker-pool.h"
 
 #include <QtWidgets/QApplication>
 
 #include <QtGui/QOpenGLContext>
 #include <QtGui/QSurfaceFormat>
 
+#include <QtCore/QCommandLineOption>
+#include <QtCore/QCommandLineParser>
 #include <QtCore/QCoreApplication>
 #include <QtCore/QVariant>
 
@@ -19,9 +25,12 @@
 #include "stl-ext/any"
 #endif
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <cstdlib>
 #include <memory>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -138,8 +147,66 @@ int32_t main(
    QApplication application {
       _argc, _argv.first.data() };
 
+   // a single render thread shares the gl objects of all views
+   const QCommandLineOption render_threads_option {
+      "render-threads",
+      "Number of render threads, one shares the gl objects of all views.",
+      "count" };
+
+   // the frames are presented from the fences the watcher reports
+   // signaled instead of the gpu waiting on the fences
+   const QCommandLineOption fence_watcher_option {
+      "fence-watcher",
+      "Present frames once the fence watcher reports them complete." };
+
+   QCommandLineParser command_line_parser;
+   command_line_parser.addHelpOption();
+   command_line_parser.addOption(
+      render_threads_option);
+   command_line_parser.addOption(
+      fence_watcher_option);
+   command_line_parser.process(
+      application);
+
+   QtGLView::SetServerWaitPresent(
+      !command_line_parser.isSet(fence_watcher_option));
+
+   // leave room for the gui thread and the gl driver threads
+   size_t render_thread_count {
+      std::max< size_t >(
+         std::thread::hardware_concurrency() / 2,
+         1) };
+
+   if (command_line_parser.isSet(render_threads_option))
+   {
+      render_thread_count =
+         std::max< size_t >(
+            command_line_parser.value(render_threads_option).toUInt(),
+            1);
+   }
+
+   telemetry::Start(
+      std::chrono::seconds { 5 });
+
    render_thread::Start(
-      SetupHiddenGLContextFromGlobalQtGLContext());
+      SetupHiddenGLContextFromGlobalQtGLContext(),
+      render_thread_count);
+
+   model_loader::Start(
+      std::max< size_t >(
+         std::thread::hardware_concurrency() / 4,
+         1));
+
+   if (QtGLView::UsesFenceWatcher())
+   {
+      fence_watcher::Start();
+   }
+
+   // the render threads cull on the workers and on themselves
+   worker_pool::Start(
+      std::max< size_t >(
+         std::thread::hardware_concurrency() / 2,
+         1));
 
    std::vector<
       std::unique_ptr< QtGLView > > gl_views;
@@ -201,7 +268,18 @@ int32_t main(
 
    gl_views.clear();
 
+   model_loader::Stop();
+
+   if (QtGLView::UsesFenceWatcher())
+   {
+      fence_watcher::Stop();
+   }
+
    render_thread::Stop();
 
+   worker_pool::Stop();
+
+   telemetry::Stop();
+
    return exit_code;
 }
@@ -0,0 +1,514 @@
+#include "model-loader.h"
+#include "gl-object-manager.h"
+#include "render-thread.h"
+
+#include <osgUtil/GLObjectsVisitor>
+
+#include <osgDB/FileUtils>
+#include <osgDB/ReadFile>
+
+#include <osg/GLExtensions>
+#include <osg/GraphicsContext>
+#include <osg/Node>
+#include <osg/Object>
+#include <osg/State>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+extern osg::ref_ptr< osg::GraphicsContext >
+CreateSharedGraphicsContext(
+   const char * const context_name ) noexcept;
+
+namespace model_loader
+{
+
+struct LoadRequest
+{
+   std::string model;
+   std::promise< osg::ref_ptr< osg::Node > > loaded;
+};
+
+std::vector< std::thread > loader_threads_;
+std::mutex loader_threads_mutex_;
+
+std::deque< LoadRequest > load_requests_;
+std::mutex load_requests_mutex_;
+std::condition_variable load_requests_condition_;
+bool quit_loader_threads_ { false };
+
+// only one loader thread can have the loader context current
+osg::ref_ptr< osg::GraphicsContext > loader_graphics_context_;
+std::mutex loader_graphics_context_mutex_;
+
+struct CachedModel
+{
+   int64_t modified;
+   std::shared_future< osg::ref_ptr< osg::Node > > loaded;
+   std::chrono::steady_clock::time_point last_used;
+};
+
+std::map< std::string, CachedModel > model_cache_;
+std::mutex model_cache_mutex_;
+size_t model_cache_capacity_ { 8 };
+
+std::mutex model_parents_mutex_;
+
+const size_t MODEL_TRAVERSAL_LOCKS { 64 };
+std::array< std::mutex, MODEL_TRAVERSAL_LOCKS > model_traversal_mutexes_;
+
+int64_t ModifiedTime(
+   const std::string & path )
+{
+#if _WIN32
+   struct _stat64 status { };
+
+   const bool valid =
+      _stat64(path.c_str(), &status) == 0;
+#elif __linux__
+   struct stat status { };
+
+   const bool valid =
+      stat(path.c_str(), &status) == 0;
+#else
+#error "Define for this platform!"
+#endif
+
+   return
+      valid ?
+      static_cast< int64_t >(status.st_mtime) :
+      -1;
+}
+
+bool IsModelUnused(
+   const CachedModel & cached_model )
+{
+   bool unused { false };
+
+   if (cached_model.loaded.wait_for(std::chrono::seconds { 0 }) ==
+       std::future_status::ready)
+   {
+      const auto & model_node =
+         cached_model.loaded.get();
+
+      // the shared state of the future holds the only reference
+      unused =
+         !model_node ||
+         model_node->referenceCount() == 1;
+   }
+
+   return unused;
+}
+
+void EvictUnusedModels( )
+{
+   std::vector< decltype(model_cache_)::iterator > unused_models;
+
+   for (auto cached_model = model_cache_.begin();
+        cached_model != model_cache_.end();
+        ++cached_model)
+   {
+      if (IsModelUnused(cached_model->second))
+      {
+         unused_models.push_back(
+            cached_model);
+      }
+   }
+
+   if (unused_models.size() > model_cache_capacity_)
+   {
+      std::sort(
+         unused_models.begin(),
+         unused_models.end(),
+         [ ] ( const auto & lhs, const auto & rhs )
+         {
+            return lhs->second.last_used < rhs->second.last_used;
+         });
+
+      unused_models.resize(
+         unused_models.size() - model_cache_capacity_);
+
+      for (const auto & unused_model : unused_models)
+      {
+         model_cache_.erase(
+            unused_model);
+      }
+   }
+}
+
+osg::ref_ptr< osg::Node > ReadModel(
+   const std::string & model )
+{
+   const auto model_node =
+      osgDB::readRefNodeFile(
+         model);
+
+   if (model_node)
+   {
+      // the model is shared between views and possibly
+      // culled by several render threads at the same time
+      model_node->setDataVariance(
+         osg::Object::STATIC);
+      model_node->getBound();
+   }
+
+   return model_node;
+}
+
+void CompileGLObjects(
+   osg::Node & node )
+{
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      loader_graphics_context_mutex_ };
+#else
+   std::lock_guard< decltype(loader_graphics_context_mutex_) > lock {
+      loader_graphics_context_mutex_ };
+#endif
+
+   if (loader_graphics_context_ &&
+       loader_graphics_context_->makeCurrent())
+   {
+      const auto state =
+         loader_graphics_context_->getState();
+
+      if (!state->get< osg::GLExtensions >())
+      {
+         state->initializeExtensionProcs();
+      }
+
+      {
+         const auto gl_objects_lock =
+            gl_objects::Lock(
+               state->getContextID());
+
+         osgUtil::GLObjectsVisitor gl_objects_visitor {
+            osgUtil::GLObjectsVisitor::COMPILE_DISPLAY_LISTS |
+            osgUtil::GLObjectsVisitor::COMPILE_STATE_ATTRIBUTES |
+            osgUtil::GLObjectsVisitor::CHECK_BLACK_LISTED_MODES };
+
+         gl_objects_visitor.setState(
+            state);
+
+         node.accept(
+            gl_objects_visitor);
+      }
+
+      // the objects must be complete before
+      // another context is allowed to use them
+      glFinish();
+
+      loader_graphics_context_->releaseContext();
+   }
+}
+
+void LoaderLoop( )
+{
+   while (true)
+   {
+      LoadRequest load_request;
+
+      {
+         std::unique_lock< std::mutex > lock {
+            load_requests_mutex_ };
+
+         load_requests_condition_.wait(
+            lock,
+            [ ] ( )
+            {
+               return
+                  quit_loader_threads_ ||
+                  !load_requests_.empty();
+            });
+
+         if (load_requests_.empty())
+         {
+            break;
+         }
+
+         load_request =
+            std::move(load_requests_.front());
+
+         load_requests_.pop_front();
+      }
+
+      const auto model_node =
+         ReadModel(
+            load_request.model);
+
+      if (model_node)
+      {
+         CompileGLObjects(
+            *model_node);
+      }
+
+      load_request.loaded.set_value(
+         model_node);
+   }
+}
+
+void Start(
+   const size_t loader_thread_count ) noexcept
+{
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      loader_threads_mutex_ };
+#else
+   std::lock_guard< decltype(loader_threads_mutex_) > lock {
+      loader_threads_mutex_ };
+#endif
+
+   if (loader_threads_.empty())
+   {
+      render_thread::AddOperation(
+         [ ] ( )
+         {
+            loader_graphics_context_ =
+               CreateSharedGraphicsContext(
+                  "loader graphics context");
+
+            // objects compiled for a context id the views
+            // do not use would only be compiled again
+            if (loader_graphics_context_ &&
+                !gl_objects::IsSharedContextID(
+                  loader_graphics_context_->getState()->getContextID()))
+            {
+               loader_graphics_context_ = nullptr;
+            }
+         }).wait();
+
+      quit_loader_threads_ = false;
+
+      for (size_t i { 0 }; i < loader_thread_count; ++i)
+      {
+         loader_threads_.emplace_back(
+            &LoaderLoop);
+      }
+   }
+}
+
+void Stop( ) noexcept
+{
+   {
+#if _has_cxx_class_template_argument_deduction
+      std::lock_guard lock {
+         model_cache_mutex_ };
+#else
+      std::lock_guard< decltype(model_cache_mutex_) > lock {
+         model_cache_mutex_ };
+#endif
+
+      model_cache_.clear();
+   }
+
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      loader_threads_mutex_ };
+#else
+   std::lock_guard< decltype(loader_threads_mutex_) > lock {
+      loader_threads_mutex_ };
+#endif
+
+   if (!loader_threads_.empty())
+   {
+      {
+#if _has_cxx_class_template_argument_deduction
+         std::lock_guard requests_lock {
+            load_requests_mutex_ };
+#else
+         std::lock_guard< decltype(load_requests_mutex_) > requests_lock {
+            load_requests_mutex_ };
+#endif
+
+         quit_loader_threads_ = true;
+      }
+
+      load_requests_condition_.notify_all();
+
+      for (auto & loader_thread : loader_threads_)
+      {
+         loader_thread.join();
+      }
+
+      loader_threads_.clear();
+
+      render_thread::AddOperation(
+         [ ] ( )
+         {
+            loader_graphics_context_ = nullptr;
+         }).wait();
+   }
+}
+
+void QueueLoad(
+   LoadRequest load_request )
+{
+   bool queued { false };
+
+   {
+#if _has_cxx_class_template_argument_deduction
+      std::lock_guard lock {
+         loader_threads_mutex_ };
+#else
+      std::lock_guard< decltype(loader_threads_mutex_) > lock {
+         loader_threads_mutex_ };
+#endif
+
+      if (!loader_threads_.empty())
+      {
+#if _has_cxx_class_template_argument_deduction
+         std::lock_guard requests_lock {
+            load_requests_mutex_ };
+#else
+         std::lock_guard< decltype(load_requests_mutex_) > requests_lock {
+            load_requests_mutex_ };
+#endif
+
+         load_requests_.emplace_back(
+            std::move(load_request));
+
+         queued = true;
+      }
+   }
+
+   if (queued)
+   {
+      load_requests_condition_.notify_one();
+   }
+   else
+   {
+      load_request.loaded.set_value(
+         ReadModel(
+            load_request.model));
+   }
+}
+
+std::shared_future< osg::ref_ptr< osg::Node > > Load(
+   std::string model ) noexcept
+{
+   auto path =
+      osgDB::findDataFile(
+         model);
+
+   if (path.empty())
+   {
+      path = std::move(model);
+   }
+
+   const auto modified =
+      ModifiedTime(
+         path);
+
+   LoadRequest load_request;
+   bool load { false };
+
+   std::shared_future< osg::ref_ptr< osg::Node > > loaded;
+
+   {
+#if _has_cxx_class_template_argument_deduction
+      std::lock_guard lock {
+         model_cache_mutex_ };
+#else
+      std::lock_guard< decltype(model_cache_mutex_) > lock {
+         model_cache_mutex_ };
+#endif
+
+      auto & cached_model =
+         model_cache_[path];
+
+      if (!cached_model.loaded.valid() ||
+          cached_model.modified != modified)
+      {
+         // a modified file replaces the cached model, but the
+         // views already using the previous model keep it alive
+         load_request.model = path;
+         load = true;
+
+         cached_model.modified = modified;
+         cached_model.loaded = load_request.loaded.get_future();
+      }
+
+      cached_model.last_used =
+         std::chrono::steady_clock::now();
+
+      loaded =
+         cached_model.loaded;
+
+      EvictUnusedModels();
+   }
+
+   // the model may be read on this thread, which must not keep the
+   // other views from finding their models in the cache meanwhile
+   if (load)
+   {
+      QueueLoad(
+         std::move(load_request));
+   }
+
+   return loaded;
+}
+
+void SetCacheCapacity(
+   const size_t unused_models ) noexcept
+{
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      model_cache_mutex_ };
+#else
+   std::lock_guard< decltype(model_cache_mutex_) > lock {
+      model_cache_mutex_ };
+#endif
+
+   model_cache_capacity_ = unused_models;
+
+   EvictUnusedModels();
+}
+
+size_t CachedModels( ) noexcept
+{
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      model_cache_mutex_ };
+#else
+   std::lock_guard< decltype(model_cache_mutex_) > lock {
+      model_cache_mutex_ };
+#endif
+
+   return model_cache_.size();
+}
+
+std::unique_lock< std::mutex > LockModelParents( ) noexcept
+{
+   return
+      std::unique_lock< std::mutex > {
+         model_parents_mutex_ };
+}
+
+std::unique_lock< std::mutex > LockModelTraversal(
+   const osg::Node & model ) noexcept
+{
+   // nodes are heap allocated, so the low bits of the address vary
+   // the least and are shifted out before picking the lock
+   const auto lock_index =
+      (reinterpret_cast< uintptr_t >(&model) >> 4) %
+      MODEL_TRAVERSAL_LOCKS;
+
+   return
+      std::unique_lock< std::mutex > {
+         model_traversal_mutexes_[lock_index] };
+}
+
+} // namespace model_loader
@@ -0,0 +1,57 @@
+#ifndef _MODEL_LOADER_H_
+#define _MODEL_LOADER_H_
+
+#include <osg/ref_ptr>
+
+#include <cstddef>
+#include <future>
+#include <mutex>
+#include <string>
+
+namespace osg
+{
+class Node;
+}
+
+namespace model_loader
+{
+
+// starts the loader threads that read models in parallel.  when
+// the views share the context id of the hidden gl context, as they
+// do with a single render thread, the gl objects of a loaded model
+// are compiled on a loader context that shares with the hidden gl
+// context, so the hidden context must be initialized before the
+// loader is started.  otherwise the views compile them.
+void Start(
+   const size_t loader_thread_count ) noexcept;
+void Stop( ) noexcept;
+
+// models are cached by path and modification time, so every
+// view of the same file shares one immutable subgraph and one set
+// of gl objects.  when the loader is not running the model is read
+// on the calling thread and the returned future is satisfied.
+std::shared_future< osg::ref_ptr< osg::Node > > Load(
+   std::string model ) noexcept;
+
+// number of models no longer referenced by any view that are kept
+// in the cache.  the least recently used ones are evicted first.
+void SetCacheCapacity(
+   const size_t unused_models ) noexcept;
+size_t CachedModels( ) noexcept;
+
+// a cached model is attached to the scene graphs of views on several
+// render threads, and attaching or detaching it changes its parent
+// list.  the lock must be held while a view attaches or detaches a
+// cached model, including when a scene graph holding one is released.
+std::unique_lock< std::mutex > LockModelParents( ) noexcept;
+
+// the update callbacks of a cached model change the model itself, so
+// views on different render threads must not update it at once, nor
+// cull it while another view updates it.  the lock is picked by the
+// address of the model from a fixed set, so it is never released.
+std::unique_lock< std::mutex > LockModelTraversal(
+   const osg::Node & model ) noexcept;
+
+} // namespace model_loader
+
+#endif // _MODEL_LOADER_H_
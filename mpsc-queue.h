@@ -0,0 +1,242 @@
+#ifndef _MPSC_QUEUE_H_
+#define _MPSC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+// unbounded lock-free multiple producer single consumer queue.
+// producers never wait on each other or the consumer.  a value
+// pushed while the consumer is popping may not be visible until
+// the next pop, which is acceptable for per frame draining.
+//
+// nodes released by the consumer are recycled to the producers,
+// so once warmed up pushing and popping do not allocate.
+template < typename T >
+class MPSCQueue final
+{
+public:
+   MPSCQueue( ) noexcept;
+   ~MPSCQueue( ) noexcept;
+
+   MPSCQueue( MPSCQueue && ) noexcept = delete;
+   MPSCQueue( const MPSCQueue & ) noexcept = delete;
+
+   MPSCQueue & operator = ( MPSCQueue && ) noexcept = delete;
+   MPSCQueue & operator = ( const MPSCQueue & ) noexcept = delete;
+
+   // safe to call from any thread
+   void Push(
+      T value ) noexcept;
+   size_t Size( ) const noexcept;
+
+   // must only be called from the consumer thread
+   bool Pop(
+      T & value ) noexcept;
+
+private:
+   struct Node
+   {
+      std::atomic< Node * > next { nullptr };
+      T value;
+   };
+
+   // nodes taken from the free list are owned by the producing
+   // thread until they are pushed.  only the consumer pushes to
+   // the free list and the producers take the complete list, so
+   // the free list does not suffer from the aba problem.
+   struct NodeCache
+   {
+      ~NodeCache( ) noexcept;
+
+      Node * nodes { nullptr };
+   };
+
+   Node * AcquireNode( ) noexcept;
+   void ReleaseNode(
+      Node * const node ) noexcept;
+   static void DeleteNodes(
+      Node * nodes ) noexcept;
+
+   std::atomic< Node * > head_;
+   Node * tail_;
+
+   std::atomic< size_t > size_;
+
+   std::atomic< Node * > free_nodes_;
+
+   static thread_local NodeCache node_cache_;
+
+};
+
+template < typename T >
+thread_local typename MPSCQueue< T >::NodeCache
+   MPSCQueue< T >::node_cache_;
+
+template < typename T >
+inline MPSCQueue< T >::NodeCache::~NodeCache( ) noexcept
+{
+   DeleteNodes(
+      nodes);
+}
+
+template < typename T >
+inline MPSCQueue< T >::MPSCQueue( ) noexcept :
+head_ { new Node },
+tail_ { head_.load() },
+size_ { 0 },
+free_nodes_ { nullptr }
+{
+}
+
+template < typename T >
+inline MPSCQueue< T >::~MPSCQueue( ) noexcept
+{
+   T value;
+
+   while (Pop(value));
+
+   delete tail_;
+
+   DeleteNodes(
+      free_nodes_.exchange(nullptr));
+}
+
+template < typename T >
+inline void MPSCQueue< T >::Push(
+   T value ) noexcept
+{
+   const auto node =
+      AcquireNode();
+
+   node->value =
+      std::move(value);
+
+   size_.fetch_add(
+      1,
+      std::memory_order_relaxed);
+
+   const auto previous =
+      head_.exchange(
+         node,
+         std::memory_order_acq_rel);
+
+   previous->next.store(
+      node,
+      std::memory_order_release);
+}
+
+template < typename T >
+inline size_t MPSCQueue< T >::Size( ) const noexcept
+{
+   return
+      size_.load(
+         std::memory_order_relaxed);
+}
+
+template < typename T >
+inline bool MPSCQueue< T >::Pop(
+   T & value ) noexcept
+{
+   const auto tail =
+      tail_;
+
+   const auto next =
+      tail->next.load(
+         std::memory_order_acquire);
+
+   if (next)
+   {
+      // the next node becomes the new stub node
+      value =
+         std::move(next->value);
+
+      tail_ = next;
+
+      ReleaseNode(
+         tail);
+
+      size_.fetch_sub(
+         1,
+         std::memory_order_relaxed);
+   }
+
+   return next;
+}
+
+template < typename T >
+inline typename MPSCQueue< T >::Node *
+MPSCQueue< T >::AcquireNode( ) noexcept
+{
+   auto & node_cache =
+      node_cache_;
+
+   if (!node_cache.nodes)
+   {
+      node_cache.nodes =
+         free_nodes_.exchange(
+            nullptr,
+            std::memory_order_acquire);
+   }
+
+   Node * node { nullptr };
+
+   if (node_cache.nodes)
+   {
+      node = node_cache.nodes;
+
+      node_cache.nodes =
+         node->next.load(
+            std::memory_order_relaxed);
+
+      node->next.store(
+         nullptr,
+         std::memory_order_relaxed);
+   }
+   else
+   {
+      node = new Node;
+   }
+
+   return node;
+}
+
+template < typename T >
+inline void MPSCQueue< T >::ReleaseNode(
+   Node * const node ) noexcept
+{
+   auto free_nodes =
+      free_nodes_.load(
+         std::memory_order_relaxed);
+
+   do
+   {
+      node->next.store(
+         free_nodes,
+         std::memory_order_relaxed);
+   }
+   while (
+      !free_nodes_.compare_exchange_weak(
+         free_nodes,
+         node,
+         std::memory_order_release,
+         std::memory_order_relaxed));
+}
+
+template < typename T >
+inline void MPSCQueue< T >::DeleteNodes(
+   Node * nodes ) noexcept
+{
+   while (nodes)
+   {
+      const auto next =
+         nodes->next.load(
+            std::memory_order_relaxed);
+
+      delete nodes;
+
+      nodes = next;
+   }
+}
+
+#endif // _MPSC_QUEUE_H_
@@ -0,0 +1,154 @@
+#include "multisample-governor.h"
+
+// frames averaged before the level is reconsidered
+static const uint32_t WINDOW_FRAMES { 15 };
+// windows in a row that must leave headroom before stepping up
+static const uint32_t STEP_UP_WINDOWS { 8 };
+// a level roughly doubles the cost of the samples of the one below,
+// so stepping up needs a window well under the budget
+static const double STEP_UP_HEADROOM { 0.5 };
+
+MultisampleGovernor::MultisampleGovernor(
+   const Multisample maximum_level,
+   const uint32_t settle_frames ) noexcept :
+maximum_level_ { maximum_level },
+settle_frames_ { settle_frames },
+frame_budget_ { Clock::duration::zero() },
+level_ { maximum_level },
+unsettled_frames_ { 0 },
+window_frames_ { 0 },
+window_cost_ { Clock::duration::zero() },
+window_frame_cost_ { Clock::duration::zero() },
+headroom_windows_ { 0 }
+{
+}
+
+void MultisampleGovernor::SetFrameBudget(
+   const Clock::duration frame_budget ) noexcept
+{
+   frame_budget_ = frame_budget;
+}
+
+MultisampleGovernor::Clock::duration
+MultisampleGovernor::FrameBudget( ) const noexcept
+{
+   return frame_budget_;
+}
+
+bool MultisampleGovernor::AddFrameCost(
+   const Clock::duration frame_cost ) noexcept
+{
+   const auto frame_budget =
+      frame_budget_.load();
+
+   if (frame_budget == Clock::duration::zero())
+   {
+      return false;
+   }
+
+   if (unsettled_frames_)
+   {
+      --unsettled_frames_;
+
+      return false;
+   }
+
+   window_cost_ += frame_cost;
+
+   if (++window_frames_ < WINDOW_FRAMES)
+   {
+      return false;
+   }
+
+   window_frame_cost_ =
+      window_cost_ / window_frames_;
+
+   window_frames_ = 0;
+   window_cost_ = Clock::duration::zero();
+
+   auto level =
+      level_;
+
+   if (window_frame_cost_ > frame_budget)
+   {
+      headroom_windows_ = 0;
+
+      level =
+         LowerLevel(
+            level_);
+   }
+   else if (window_frame_cost_ <
+            std::chrono::duration_cast< Clock::duration >(
+               frame_budget * STEP_UP_HEADROOM))
+   {
+      if (++headroom_windows_ >= STEP_UP_WINDOWS)
+      {
+         headroom_windows_ = 0;
+
+         level =
+            HigherLevel(
+               level_);
+
+         if (static_cast< int >(level) >
+             static_cast< int >(maximum_level_))
+         {
+            level = level_;
+         }
+      }
+   }
+   else
+   {
+      headroom_windows_ = 0;
+   }
+
+   const bool changed {
+      level != level_ };
+
+   if (changed)
+   {
+      level_ = level;
+      unsettled_frames_ = settle_frames_;
+   }
+
+   return changed;
+}
+
+Multisample MultisampleGovernor::Level( ) const noexcept
+{
+   return level_;
+}
+
+MultisampleGovernor::Clock::duration
+MultisampleGovernor::WindowFrameCost( ) const noexcept
+{
+   return window_frame_cost_;
+}
+
+uint32_t MultisampleGovernor::WindowFrames( ) const noexcept
+{
+   return WINDOW_FRAMES;
+}
+
+Multisample MultisampleGovernor::LowerLevel(
+   const Multisample level ) noexcept
+{
+   switch (level)
+   {
+   case Multisample::SIXTEEN: return Multisample::EIGHT;
+   case Multisample::EIGHT: return Multisample::FOUR;
+   case Multisample::FOUR: return Multisample::TWO;
+   default: return Multisample::NONE;
+   }
+}
+
+Multisample MultisampleGovernor::HigherLevel(
+   const Multisample level ) noexcept
+{
+   switch (level)
+   {
+   case Multisample::NONE: return Multisample::TWO;
+   case Multisample::TWO: return Multisample::FOUR;
+   case Multisample::FOUR: return Multisample::EIGHT;
+   default: return Multisample::SIXTEEN;
+   }
+}
@@ -0,0 +1,62 @@
+#ifndef _MULTISAMPLE_GOVERNOR_H_
+#define _MULTISAMPLE_GOVERNOR_H_
+
+#include "multisample.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// picks the multisample level of a view from its measured frame
+// cost.  the level steps down as soon as a window of frames costs
+// more than the budget on average and only steps back up after
+// several windows in a row left plenty of headroom, so the level
+// does not flip back and forth around the budget.
+class MultisampleGovernor final
+{
+public:
+   using Clock = std::chrono::steady_clock;
+
+   // the level never steps above the maximum.  the costs of the
+   // settle frames following a change are ignored, as those frames
+   // may have been drawn before the change.
+   MultisampleGovernor(
+      const Multisample maximum_level,
+      const uint32_t settle_frames ) noexcept;
+
+   // a budget of zero keeps the current level
+   void SetFrameBudget(
+      const Clock::duration frame_budget ) noexcept;
+   Clock::duration FrameBudget( ) const noexcept;
+
+   // returns if the frame cost changed the level
+   bool AddFrameCost(
+      const Clock::duration frame_cost ) noexcept;
+
+   Multisample Level( ) const noexcept;
+   // the average frame cost of the last complete window
+   Clock::duration WindowFrameCost( ) const noexcept;
+   uint32_t WindowFrames( ) const noexcept;
+
+private:
+   static Multisample LowerLevel(
+      const Multisample level ) noexcept;
+   static Multisample HigherLevel(
+      const Multisample level ) noexcept;
+
+   const Multisample maximum_level_;
+   const uint32_t settle_frames_;
+
+   std::atomic< Clock::duration > frame_budget_;
+
+   Multisample level_;
+
+   uint32_t unsettled_frames_;
+   uint32_t window_frames_;
+   Clock::duration window_cost_;
+   Clock::duration window_frame_cost_;
+   uint32_t headroom_windows_;
+
+};
+
+#endif // _MULTISAMPLE_GOVERNOR_H_
@@ -1,18 +1,25 @@
 #include "osg-view.h"
+#include "block-pool.h"
+#include "frame-telemetry.h"
+#include "color-buffer-pool.h"
 #include "gl-fence-sync.h"
+#include "gl-invalidate-frame-buffer.h"
+#include "gl-object-manager.h"
+#include "gl-timer-query.h"
+#include "model-loader.h"
 #include "multisample.h"
 #if _WIN32
 #include "osg-gc-wrapper.h"
 #endif
-#include "osg-view-mouse-event.h"
-
-#include <QtCore/QEvent>
+#include "render-target-pool.h"
+#include "swap-chain.h"
 
 #if _WIN32
 #include <osgViewer/api/Win32/GraphicsHandleWin32>
 #include <osgViewer/api/Win32/GraphicsWindowWin32>
 #endif // _WIN32
 
+#include <osgUtil/IncrementalCompileOperation>
 #include <osgUtil/RenderStage>
 #include <osgUtil/SceneView>
 #include <osgUtil/UpdateVisitor>
@@ -20,29 +27,38 @@
 #include <osgText/String>
 #include <osgText/Text>
 
-#include <osgDB/ReadFile>
-
 #include <osg/AutoTransform>
 #include <osg/Camera>
 #include <osg/DisplaySettings>
 #include <osg/FrameStamp>
 #include <osg/FrameBufferObject>
 #include <osg/GLExtensions>
+#include <osg/Geode>
 #include <osg/GraphicsContext>
+#include <osg/Group>
 #include <osg/Matrix>
 #include <osg/MatrixTransform>
+#include <osg/NodeCallback>
+#include <osg/NodeVisitor>
 #include <osg/Projection>
 #include <osg/ref_ptr>
+#include <osg/Shape>
+#include <osg/ShapeDrawable>
 #include <osg/Texture>
 #include <osg/Texture2D>
+#include <osg/Texture2DArray>
 #include <osg/Texture2DMultisample>
 #include <osg/Vec3>
 
 #include <QMetaType>
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <mutex>
 #include <type_traits>
 
 #if __linux__
@@ -55,17 +71,64 @@
 #define USE_GL_FLUSH 1
 #define USE_GL_FINISH 0
 #define USE_SINGLE_DEPTH_STENCIL_MULTISAMPLE_ATTACHMENT 1
+#define USE_RENDER_ON_DEMAND 1
+#define USE_INCREMENTAL_GL_COMPILE 1
+#define USE_GPU_TIMER_QUERIES 1
+// the color buffers are layers of texture arrays shared by the views
+#define USE_COLOR_BUFFER_ARRAY 0
+// the multisample attachments are borrowed from the render target
+// pool.  the textures are created per context id, so the views of
+// the same size only share them when the views share a context id.
+#define USE_SHARED_MULTISAMPLE_TARGETS 1
+// the multisample level follows the measured frame cost of the view
+#define USE_ADAPTIVE_MULTISAMPLE 1
+// render targets are allocated with immutable storage
+#define USE_IMMUTABLE_TEXTURE_STORAGE 1
+// the attachments only needed while drawing are invalidated
+#define USE_FRAME_BUFFER_INVALIDATION 1
+// the render scale follows the measured frame cost of the view
+#define USE_ADAPTIVE_RENDER_SCALE 1
+
+// gl objects of a new model compiled per frame and view
+static const std::chrono::microseconds GL_COMPILE_TIME_BUDGET { 4000 };
+// the per context buffers of osg objects are sized for this many
+// context ids when the objects are created
+static const unsigned int MAXIMUM_GRAPHICS_CONTEXTS { 64 };
+// a multisample target holds an rgba8 color sample and a depth
+// stencil sample, which a packed depth32f stencil8 stores in 8 bytes
+#if USE_SINGLE_DEPTH_STENCIL_MULTISAMPLE_ATTACHMENT
+static const uint32_t MULTISAMPLE_BYTES_PER_SAMPLE { 4 + 8 };
+#else
+static const uint32_t MULTISAMPLE_BYTES_PER_SAMPLE { 4 + 4 + 1 };
+#endif
+// frames a gpu timing may be in flight before it is read back
+static const size_t GPU_TIMER_LATENCY { 4 };
+// gpu time a view may spend drawing and resolving a frame before its
+// render scale or multisample level is lowered.  a few views share
+// a 60 hz frame.
+static const std::chrono::microseconds GPU_FRAME_BUDGET { 6000 };
+// the adaptive render scale renders at no less than half the size
+static const double MINIMUM_RENDER_SCALE { 0.5 };
+// render targets are allocated in buckets of this many pixels and
+// only shrink once the view is this much smaller than the bucket,
+// so resizing a window does not reallocate them every frame
+static const uint32_t RENDER_TARGET_BUCKET { 128 };
+static const uint32_t RENDER_TARGET_SHRINK_MARGIN { 256 };
+// color buffers of a view.  one is presented, one is waiting to be
+// presented and one is rendered to, plus room for a slow consumer.
+static const size_t SWAP_CHAIN_MINIMUM_DEPTH { 3 };
+static const size_t SWAP_CHAIN_MAXIMUM_DEPTH { 6 };
+// a view holds at least three layers, so a texture array shared by
+// the views of all render threads holds the color buffers of a few
+static const uint32_t SHARED_COLOR_BUFFER_ARRAY_LAYERS { 8 };
 
 static const auto qt_meta_type_int32_t =
    qRegisterMetaType< int32_t >("int32_t");
 static const auto qt_meta_type_GLuint =
    qRegisterMetaType< GLuint >("GLuint");
-static const auto qt_meta_type_std_array_doulbe_3 =
-   qRegisterMetaType< std::array< double, 3 > >(
-      "std::array< double, 3 >");
-static const auto qt_meta_type_std_shared_ptr_std_pair_GLuint_gl_FenceSync =
-   qRegisterMetaType< std::shared_ptr< std::pair< GLuint, gl::FenceSync > > >(
-      "std::shared_ptr< std::pair< GLuint, gl::FenceSync > >");
+static const auto qt_meta_type_std_shared_ptr_std_pair_ColorBuffer_gl_FenceSync =
+   qRegisterMetaType< std::shared_ptr< std::pair< ColorBuffer, gl::FenceSync > > >(
+      "std::shared_ptr< std::pair< ColorBuffer, gl::FenceSync > >");
 
 #if _WIN32
 static std::unique_ptr<
@@ -257,6 +320,42 @@ CreateGraphicsContext(
 
       HideContextWindow(
          graphics_context);
+
+      if (share_context &&
+          share_context->getState() &&
+          graphics_context->getState())
+      {
+         const auto state =
+            graphics_context->getState();
+         const auto share_context_id =
+            share_context->getState()->getContextID();
+
+         if (gl_objects::IsSharedContextID(share_context_id))
+         {
+            // contexts sharing lists also share the gl objects, so
+            // the osg objects only need to be compiled once for all
+            if (state->getContextID() != share_context_id)
+            {
+               osg::GraphicsContext::decrementContextIDUsageCount(
+                  state->getContextID());
+               osg::GraphicsContext::incrementContextIDUsageCount(
+                  share_context_id);
+
+               state->setContextID(
+                  share_context_id);
+            }
+         }
+         else if (state->getContextID() == share_context_id)
+         {
+            // each context compiles its own copy of the osg objects
+            // and never contends with other contexts for them
+            osg::GraphicsContext::decrementContextIDUsageCount(
+               share_context_id);
+
+            state->setContextID(
+               osg::GraphicsContext::createNewContextID());
+         }
+      }
    }
 
    return graphics_context;
@@ -266,7 +365,8 @@ static osg::ref_ptr< osg::GraphicsContext >
    hidden_graphics_context_;
 
 void InitHiddenGLContext(
-   const std::any & hidden_context ) noexcept
+   const std::any & hidden_context,
+   const bool share_context_id ) noexcept
 {
    if (!hidden_graphics_context_)
    {
@@ -279,6 +379,27 @@ void InitHiddenGLContext(
             hidden_context.has_value() ?
             new OSGGraphicsContextWrapper { hidden_context } :
             nullptr);
+
+      // the contexts created from here on share the context id of
+      // the hidden context, so the osg objects are compiled once for
+      // all of them.  osg does not guard its per context objects, so
+      // the views then take turns for every compile and draw.
+      if (hidden_graphics_context_ && share_context_id)
+      {
+         gl_objects::SetSharedContextID(
+            hidden_graphics_context_->getState()->getContextID());
+      }
+      else
+      {
+         // osg grows the per context buffers of an object the first
+         // time a new context id uses it, which must not happen on
+         // several render threads at once for the models the views
+         // share
+         osg::DisplaySettings::instance()->setMaxNumberOfGraphicsContexts(
+            std::max(
+               osg::DisplaySettings::instance()->getMaxNumberOfGraphicsContexts(),
+               MAXIMUM_GRAPHICS_CONTEXTS));
+      }
    }
 }
 
@@ -286,12 +407,61 @@ void ReleaseHiddenGLContext( ) noexcept
 {
    if (hidden_graphics_context_)
    {
+      gl_objects::ReleaseSharedContextID();
+
       hidden_graphics_context_ = nullptr;
 
       graphics_subsystem_module_ = nullptr;
    }
 }
 
+osg::ref_ptr< osg::GraphicsContext >
+CreateSharedGraphicsContext(
+   const char * const context_name ) noexcept
+{
+   return
+      hidden_graphics_context_ ?
+      CreateGraphicsContext(
+         1, 1,
+         context_name,
+         hidden_graphics_context_) :
+      nullptr;
+}
+
+static thread_local osg::ref_ptr< osg::GraphicsContext >
+   render_thread_graphics_context_;
+
+void InitRenderThreadGLContext( ) noexcept
+{
+   if (!render_thread_graphics_context_)
+   {
+      render_thread_graphics_context_ =
+         CreateSharedGraphicsContext(
+            "render thread graphics context");
+   }
+}
+
+void ReleaseRenderThreadGLContext( ) noexcept
+{
+   render_thread_graphics_context_ = nullptr;
+}
+
+void MakeRenderThreadGLContextCurrent( ) noexcept
+{
+   if (render_thread_graphics_context_)
+   {
+      render_thread_graphics_context_->makeCurrent();
+   }
+}
+
+void ReleaseRenderThreadGLContextCurrent( ) noexcept
+{
+   if (render_thread_graphics_context_)
+   {
+      render_thread_graphics_context_->releaseContext();
+   }
+}
+
 OSGView::OSGView(
    const int32_t width,
    const int32_t height,
@@ -300,8 +470,36 @@ OSGView::OSGView(
    const std::string & model ) noexcept :
 width_ { static_cast< uint32_t >(width) },
 height_ { static_cast< uint32_t >(height) },
+render_width_ { width_ },
+render_height_ { height_ },
+target_width_ { 0 },
+target_height_ { 0 },
 osg_scene_view_ { new osgUtil::SceneView { nullptr } },
+draw_scene_view_ { new osgUtil::SceneView { nullptr } },
+multisample_ { multisample },
+multisample_governor_ {
+   multisample,
+   GPU_TIMER_LATENCY },
+render_scale_governor_ {
+   GPU_TIMER_LATENCY },
 QObject { nullptr },
+compiling_model_ { false },
+frame_prepared_ { false },
+frame_color_buffer_ { },
+frame_resolve_frame_buffer_ { },
+frame_multisample_ { multisample },
+frame_pending_ { false },
+draw_color_buffer_ { },
+draw_resolve_frame_buffer_ { },
+draw_multisample_ { multisample },
+draw_timer_ {
+   new gl::TimerQuery {
+      3,
+      GPU_TIMER_LATENCY } },
+invalidate_multisample_color_ { USE_FRAME_BUFFER_INVALIDATION },
+invalidate_depth_stencil_ { USE_FRAME_BUFFER_INVALIDATION },
+render_on_demand_ { USE_RENDER_ON_DEMAND },
+dirty_ { true },
 parent_ { parent },
 graphics_context_ {
    CreateGraphicsContext(
@@ -311,45 +509,126 @@ graphics_context_ {
 {
    assert(graphics_context_.get());
 
+   UpdateRenderSize();
+
    SetupOSG(model);
    SetupFrameBuffer(multisample);
    SetupSignalsSlots();
+
+#if USE_ADAPTIVE_MULTISAMPLE
+   multisample_governor_.SetFrameBudget(
+      GPU_FRAME_BUDGET);
+#endif
+
+#if USE_ADAPTIVE_RENDER_SCALE
+   SetAdaptiveRenderScale(
+      MINIMUM_RENDER_SCALE,
+      GPU_FRAME_BUDGET);
+#endif
 }
 
 OSGView::~OSGView( ) noexcept
 {
    ReleaseSignalsSlots();
 
+   telemetry::RemoveSource(
+      this);
+
+   {
+      // releasing the scene graph would detach the model, which
+      // is shared with views on other render threads, unlocked
+      const auto model_parents_lock =
+         model_loader::LockModelParents();
+
+      model_group_->removeChildren(
+         0,
+         model_group_->getNumChildren());
+      compiled_model_->removeChildren(
+         0,
+         compiled_model_->getNumChildren());
+   }
+
    graphics_context_->makeCurrent();
    completed_frames_.clear();
+   draw_timer_->Release();
+
+   {
+      const auto gl_objects_lock =
+         gl_objects::Lock(
+            graphics_context_->getState()->getContextID());
+
+      render_target_pool::Return(
+         multisample_target_);
+   }
+
    graphics_context_->releaseContext();
 }
 
 void OSGView::PreRender( ) noexcept
 {
+   UpdateModel();
 }
 
 void OSGView::Render( ) noexcept
 {
+   if (PrepareFrame())
+   {
+      UpdateFrame();
+      CullFrame();
+      SwapFrame();
+      DrawFrame();
+   }
+}
+
+bool OSGView::PrepareFrame( ) noexcept
+{
+   frame_prepared_ = false;
+
    if (osg_scene_view_)
    {
+      UpdateRenderSize();
+
+#if USE_ADAPTIVE_MULTISAMPLE
+      // a pending frame keeps the buffers it was prepared with
+      if (multisample_governor_.Level() != multisample_)
+      {
+         SetupFrameBuffer(
+            multisample_governor_.Level());
+      }
+#endif
+
       graphics_context_->makeCurrent();
 
       completed_frames_.clear();
 
+      {
+         const auto gl_objects_lock =
+            gl_objects::Lock(
+               graphics_context_->getState()->getContextID());
+
+         CompileModel();
+
 #if _has_cxx_structured_bindings
-      const auto [next_frame_setup, color_buffer_id] =
-         SetupNextFrame();
+         const auto [next_frame_setup, color_buffer] =
+            SetupNextFrame();
 #else
-      const auto next_frame =
-         SetupNextFrame();
+         const auto next_frame =
+            SetupNextFrame();
 
-      const auto next_frame_setup = next_frame.first;
-      const auto color_buffer_id = next_frame.second;
+         const auto next_frame_setup = next_frame.first;
+         const auto color_buffer = next_frame.second;
 #endif
 
-      if (next_frame_setup)
+         frame_prepared_ = next_frame_setup;
+         frame_color_buffer_ = color_buffer;
+         frame_multisample_ = multisample_;
+      }
+
+      if (frame_prepared_)
       {
+         // invalidations from this point on require another frame
+         dirty_ = false;
+
 #if OSG_VERSION_GREATER_OR_EQUAL(3, 5, 1)
          const auto frame_stamp =
             osg_scene_view_->getFrameStamp();
@@ -367,378 +646,833 @@ void OSGView::Render( ) noexcept
             1000.0);
 
          UpdateText(
-            color_buffer_id);
+            frame_color_buffer_);
+      }
 
-         osg_scene_view_->update();
-         osg_scene_view_->cull();
-         osg_scene_view_->draw();
+      graphics_context_->releaseContext();
+   }
 
-         gl::FenceSync fence_sync;
+   return frame_prepared_;
+}
 
-#if USE_GL_FLUSH
-         glFlush();
-#endif
+void OSGView::UpdateFrame( ) noexcept
+{
+   if (frame_prepared_)
+   {
+      const auto update_start =
+         std::chrono::steady_clock::now();
 
-#if USE_GL_FINISH
-         glFinish();
-#endif
+      osg_scene_view_->update();
 
-         const auto fence_sync_ptr {
-            std::make_shared< std::pair< GLuint, gl::FenceSync > >(
-               std::make_pair(
-                  color_buffer_id,
-                  std::move(fence_sync))) };
+      telemetry::Record(
+         telemetry::Phase::VIEW_UPDATE,
+         std::chrono::steady_clock::now() - update_start,
+         this);
+   }
+}
 
-         if (!fence_sync_ptr->second.Valid())
-         {
-            OnPresentComplete(
-               fence_sync_ptr);
-         }
-         else
-         {
-            emit Present(
-               fence_sync_ptr);
-         }
-      }
+void OSGView::CullFrame( ) noexcept
+{
+   if (frame_prepared_)
+   {
+      const auto cull_start =
+         std::chrono::steady_clock::now();
 
-      graphics_context_->releaseContext();
+      osg_scene_view_->cull();
+
+      telemetry::Record(
+         telemetry::Phase::VIEW_CULL,
+         std::chrono::steady_clock::now() - cull_start,
+         this);
    }
 }
 
-void OSGView::PostRender( ) noexcept
+void OSGView::SwapFrame( ) noexcept
 {
+   if (frame_prepared_)
+   {
+      frame_prepared_ = false;
+
+      std::swap(
+         osg_scene_view_,
+         draw_scene_view_);
+
+      // each scene view has a camera of its own, as the frame drawn
+      // next is drawn with the viewport and the matrices of its
+      // camera while the frame after it is prepared.  that frame
+      // starts from the camera the swapped frame was culled with.
+      const auto drawn_camera =
+         draw_scene_view_->getCamera();
+      const auto next_camera =
+         osg_scene_view_->getCamera();
+
+      next_camera->setViewMatrix(
+         drawn_camera->getViewMatrix());
+      next_camera->setProjectionMatrix(
+         drawn_camera->getProjectionMatrix());
+
+      const auto drawn_viewport =
+         drawn_camera->getViewport();
+
+      next_camera->getViewport()->setViewport(
+         drawn_viewport->x(), drawn_viewport->y(),
+         drawn_viewport->width(), drawn_viewport->height());
+
+      draw_color_buffer_ = frame_color_buffer_;
+      draw_resolve_frame_buffer_ = frame_resolve_frame_buffer_;
+      draw_multisample_ = frame_multisample_;
+      frame_pending_ = true;
+   }
 }
 
-bool OSGView::event(
-   QEvent * const event )
+void OSGView::DrawFrame( ) noexcept
 {
-   if (event->type() == MOUSE_MOVE_EVENT)
+   if (frame_pending_)
    {
-      const auto * const mouse_event =
-         static_cast< MouseEvent * >(event);
+      frame_pending_ = false;
+
+      graphics_context_->makeCurrent();
+
+      const auto draw_start =
+         std::chrono::steady_clock::now();
 
-      if (mouse_event->buttons() & Qt::LeftButton)
       {
-         const auto mtransform =
-            static_cast< osg::MatrixTransform * >(
-               osg_scene_view_->getSceneData());
+         const auto gl_objects_lock =
+            gl_objects::Lock(
+               graphics_context_->getState()->getContextID());
+
+#if USE_SHARED_MULTISAMPLE_TARGETS
+         if (draw_multisample_ != Multisample::NONE)
+         {
+            BorrowMultisampleTarget();
+         }
+         else
+         {
+            render_target_pool::Return(
+               multisample_target_);
+
+            multisample_frame_buffer_ = nullptr;
+         }
+#endif
 
-         const auto mouse_delta =
-            mouse_event->pos() - previous_mouse_pos_;
+         // the previous contents are cleared by the frame anyway
+         InvalidateFrameBuffer();
 
-         const auto matrix =
-            mtransform->getMatrix() *
-            osg::Matrix::rotate(0.0175 * mouse_delta.x(), 0.0, 0.0, 1.0);
-         
-         mtransform->setMatrix(
-            matrix);
+#if USE_GPU_TIMER_QUERIES
+         draw_timer_->BeginFrame();
+#endif
+
+         draw_scene_view_->draw();
+
+         // the final draw callback of the camera marks the end of
+         // the geometry, so the resolve is timed on its own
+         ResolveFrame();
+
+#if USE_GPU_TIMER_QUERIES
+         draw_timer_->Mark();
+#endif
+
+         // only the resolved color buffer is presented
+         InvalidateFrameBuffer();
+
+#if USE_SHARED_MULTISAMPLE_TARGETS
+         if (multisample_target_)
+         {
+            multisample_target_->FenceDraw();
+         }
+#endif
+
+#if USE_GPU_TIMER_QUERIES
+         draw_timer_->EndFrame();
+#endif
       }
 
-      previous_mouse_pos_ =
-         mouse_event->pos();
+      retired_model_ = nullptr;
+
+      const auto draw_time =
+         std::chrono::steady_clock::now() - draw_start;
+
+      telemetry::Record(
+         telemetry::Phase::VIEW_DRAW,
+         draw_time,
+         this);
+
+#if USE_GPU_TIMER_QUERIES
+      RecordGPUTime();
+#else
+      // without gpu timings the time to submit the frame stands in
+      // for its cost, which understates the cost of the resolve
+      GovernFrameCost(
+         draw_time);
+#endif
+
+      PresentFrame(
+         InsertFence());
+
+      graphics_context_->releaseContext();
    }
+}
 
-    return
-       QObject::event(event);
+void OSGView::PresentFrame(
+   gl::FenceSync fence_sync ) noexcept
+{
+   // the tokens are recycled through a block pool, as a view
+   // presents one for every frame it renders
+   const auto frame_token {
+      std::allocate_shared< std::pair< ColorBuffer, gl::FenceSync > >(
+         BlockPoolAllocator<
+            std::pair< ColorBuffer, gl::FenceSync > > { },
+         draw_color_buffer_,
+         std::move(fence_sync)) };
+
+   if (!frame_token->second.Valid())
+   {
+      OnPresentComplete(
+         frame_token);
+   }
+   else
+   {
+      emit Present(
+         frame_token);
+   }
 }
 
-void OSGView::OnPresentComplete(
-   const std::shared_ptr<
-      std::pair< GLuint, gl::FenceSync > > & fence_sync ) noexcept
+gl::FenceSync OSGView::InsertFence( ) noexcept
 {
-#if _has_cxx_std_map_extract
-   inactive_frame_buffers_.insert(
-      active_frame_buffers_.extract(
-         fence_sync->first));
-#else
-   const auto active_frame_buffer =
-      active_frame_buffers_.find(
-         fence_sync->first);
+   const auto fence_start =
+      std::chrono::steady_clock::now();
 
-   inactive_frame_buffers_.insert({
-      active_frame_buffer->first,
-      active_frame_buffer->second});
+   gl::FenceSync fence_sync;
 
-   active_frame_buffers_.erase(
-      active_frame_buffer);
+#if USE_GL_FLUSH
+   glFlush();
 #endif
 
-   completed_frames_.push_back(
-      fence_sync);
+#if USE_GL_FINISH
+   glFinish();
+#endif
+
+   telemetry::Record(
+      telemetry::Phase::VIEW_FENCE,
+      std::chrono::steady_clock::now() - fence_start,
+      this);
+
+   return fence_sync;
 }
 
-void OSGView::OnSetCameraLookAt(
-   const std::array< double, 3 > & eye,
-   const std::array< double, 3 > & center,
-   const std::array< double, 3 > & up ) noexcept
+void OSGView::RecordGPUTime( ) noexcept
 {
-   osg_scene_view_->getCamera()->setViewMatrix(
-      osg::Matrix::lookAt(
-         osg::Vec3d { eye[0], eye[1], eye[2] },
-         osg::Vec3d { center[0], center[1], center[2] },
-         osg::Vec3d { up[0], up[1], up[2] }));
+   // only the results that are available are read, which
+   // are those of frames drawn a few frames earlier
+   while (draw_timer_->Intervals(draw_gpu_intervals_))
+   {
+      telemetry::Record(
+         telemetry::Phase::VIEW_GPU_GEOMETRY,
+         draw_gpu_intervals_[0],
+         this);
+      telemetry::Record(
+         telemetry::Phase::VIEW_GPU_RESOLVE,
+         draw_gpu_intervals_[1],
+         this);
+
+      GovernFrameCost(
+         draw_gpu_intervals_[0] +
+         draw_gpu_intervals_[1]);
+   }
 }
 
-void OSGView::SetupOSG(
-   const std::string & model ) noexcept
+void OSGView::GovernFrameCost(
+   const std::chrono::steady_clock::duration frame_cost ) noexcept
 {
-   if (!graphics_context_->getState()->get< osg::GLExtensions >())
+   const auto scale =
+      render_scale_governor_.Scale();
+
+   if (render_scale_governor_.AddFrameCost(frame_cost))
    {
-      graphics_context_->makeCurrent();
-      graphics_context_->getState()->initializeExtensionProcs();
-      graphics_context_->releaseContext();
+      // the color buffers are resized when the next frame is prepared
+      telemetry::RecordEvent(
+         telemetry::Event::RENDER_SCALE_CHANGED,
+         scale,
+         render_scale_governor_.Scale(),
+         this);
    }
 
-   graphics_context_->getState()->get< osg::GLExtensions >(
-      )->isTextureStorageEnabled = false;
+#if USE_ADAPTIVE_MULTISAMPLE
+   // the render scale takes up changes in cost first.  the samples
+   // are only lowered once the scale cannot go lower and are only
+   // raised while the scale is at its highest and within budget.
+   const bool govern_multisample {
+      render_scale_governor_.AtMinimumScale() ||
+      (render_scale_governor_.AtMaximumScale() &&
+       frame_cost <= multisample_governor_.FrameBudget()) };
 
-   osg_scene_view_->setDefaults();
+   const auto level =
+      multisample_governor_.Level();
 
-   osg_scene_view_->setState(
-      graphics_context_->getState());
+   if (govern_multisample &&
+       multisample_governor_.AddFrameCost(frame_cost))
+   {
+      // the frame buffers are rebuilt when the next frame is prepared
+      telemetry::RecordEvent(
+         telemetry::Event::MULTISAMPLE_CHANGED,
+         static_cast< double >(level),
+         static_cast< double >(multisample_governor_.Level()),
+         this);
+   }
+#endif
+}
 
-   osg_scene_view_->setUpdateVisitor(
-      new osgUtil::UpdateVisitor);
+bool OSGView::FramePending( ) const noexcept
+{
+   return frame_pending_;
+}
 
-   osg_scene_view_->setAutomaticFlush(true);
+void OSGView::PostRender( ) noexcept
+{
+}
 
-   osg_scene_view_->setRenderStage(
-      new osgUtil::RenderStage);
+void OSGView::SetRenderOnDemand(
+   const bool render_on_demand ) noexcept
+{
+   render_on_demand_ = render_on_demand;
 
-   const auto model_node =
-      osgDB::readRefNodeFile(
-         model);
+   Invalidate();
+}
 
-   const auto mtransform =
-      new osg::MatrixTransform;
+void OSGView::SetSwapChainDepth(
+   const size_t minimum_depth,
+   const size_t maximum_depth ) noexcept
+{
+   swap_chain_->SetDepth(
+      minimum_depth,
+      maximum_depth);
+}
 
-   mtransform->addChild(
-      model_node);
+SwapChainStatistics OSGView::GetSwapChainStatistics( ) const noexcept
+{
+   return
+      swap_chain_->Statistics();
+}
 
-   const auto text_ortho_projection {
-      new osg::Projection {
-         osg::Matrix::ortho(
-            0.0, width_,
-            0.0, height_,
-            -1.0, 1.0) } };
-   
-   text_ortho_projection->addChild(
-      new osgText::Text);
+void OSGView::SetInvalidateAttachments(
+   const bool multisample_color,
+   const bool depth_stencil ) noexcept
+{
+   invalidate_multisample_color_ = multisample_color;
+   invalidate_depth_stencil_ = depth_stencil;
+}
 
-   const auto rotate_to_screen {
-      new osg::AutoTransform };
+void OSGView::SetRenderScale(
+   const double render_scale ) noexcept
+{
+   render_scale_governor_.SetFrameBudget(
+      std::chrono::steady_clock::duration::zero());
+   render_scale_governor_.SetScaleRange(
+      render_scale,
+      render_scale);
 
-   rotate_to_screen->setAutoRotateMode(
-      osg::AutoTransform::ROTATE_TO_SCREEN);
+   Invalidate();
+}
 
-   rotate_to_screen->addChild(
-      text_ortho_projection);
+void OSGView::SetAdaptiveRenderScale(
+   const double minimum_scale,
+   const std::chrono::steady_clock::duration frame_budget ) noexcept
+{
+   render_scale_governor_.SetScaleRange(
+      minimum_scale,
+      1.0);
+   render_scale_governor_.SetFrameBudget(
+      frame_budget);
 
-   mtransform->addChild(
-      rotate_to_screen);
+   Invalidate();
+}
 
-   osg_scene_view_->setSceneData(
-      mtransform);
-   
-   if (!osg_scene_view_->getFrameStamp())
-   {
-      osg_scene_view_->setFrameStamp(
-         new osg::FrameStamp);
-   }
+static uint32_t TargetSize(
+   const uint32_t render_size,
+   const uint32_t target_size ) noexcept
+{
+   const auto bucket_size =
+      (render_size + RENDER_TARGET_BUCKET - 1) /
+      RENDER_TARGET_BUCKET * RENDER_TARGET_BUCKET;
+
+   return
+      render_size > target_size ||
+      bucket_size + RENDER_TARGET_SHRINK_MARGIN < target_size ?
+      bucket_size :
+      target_size;
+}
 
-   osg_scene_view_->getCamera()->setProjectionMatrix(
-      osg::Matrix::perspective(
-         45.0,
-         static_cast< double >(width_) /
-         static_cast< double >(height_),
-         1.0, 200.0));
+void OSGView::UpdateRenderSize( ) noexcept
+{
+   const auto scale =
+      render_scale_governor_.Scale();
+
+   render_width_ =
+      std::max(
+         static_cast< uint32_t >(std::lround(width_ * scale)),
+         1u);
+   render_height_ =
+      std::max(
+         static_cast< uint32_t >(std::lround(height_ * scale)),
+         1u);
+
+   target_width_ =
+      TargetSize(
+         render_width_,
+         target_width_);
+   target_height_ =
+      TargetSize(
+         render_height_,
+         target_height_);
+}
 
-   osg_scene_view_->getViewport()->setViewport(
-      0.0, 0.0,
-      width_, height_);
+void OSGView::Invalidate( ) noexcept
+{
+   dirty_ = true;
 }
 
-class FrameBufferSubloadCallback :
-   public osg::Texture2D::SubloadCallback
+bool OSGView::NeedsRender( ) const noexcept
 {
-public:
-   bool IsPerformingResize( ) const
+   bool needs_render {
+      !render_on_demand_ || dirty_ };
+
+   if (!needs_render && compiling_model_)
    {
-      return performing_resize_;
+      needs_render = true;
    }
 
-   void SetPerformingResize(
-      const bool resizing )
+   if (!needs_render && pending_model_.valid())
    {
-      performing_resize_ = resizing;
+      needs_render =
+         pending_model_.wait_for(std::chrono::seconds { 0 }) ==
+         std::future_status::ready;
    }
 
-   bool textureObjectValid(
-      const osg::Texture2D & texture,
-      osg::State & state ) const override
+   if (!needs_render && osg_scene_view_)
    {
-      bool valid { true };
+      // animations and other update callbacks
+      // change the scene every frame
+      const auto scene_data =
+         osg_scene_view_->getSceneData();
+
+      needs_render =
+         scene_data &&
+         (scene_data->getUpdateCallback() ||
+          scene_data->getNumChildrenRequiringUpdateTraversal());
+   }
 
-      if (!performing_resize_)
-         valid =
-            osg::Texture2D::SubloadCallback::textureObjectValid(
-               texture,
-               state);
+   return needs_render;
+}
 
-      return valid;
-   }
-   
-   void load(
-      const osg::Texture2D & texture,
-      osg::State & state ) const override
+void OSGView::MouseMove(
+   const QPoint & position,
+   const Qt::MouseButtons buttons ) noexcept
+{
+   if (buttons & Qt::LeftButton)
    {
-      const auto texture_object =
-         texture.getTextureObject(
-            state.getContextID());
+      const auto mtransform =
+         static_cast< osg::MatrixTransform * >(
+            osg_scene_view_->getSceneData());
 
-      glBindTexture(
-         GL_TEXTURE_2D,
-         texture_object->id());
+      const auto mouse_delta =
+         position - previous_mouse_pos_;
 
-      glTexImage2D(
-         GL_TEXTURE_2D,
-         0,
-         texture.getInternalFormat(),
-         texture.getTextureWidth(),
-         texture.getTextureHeight(),
-         texture.getBorderWidth(),
-         texture.getSourceFormat(),
-         texture.getSourceType(),
-         nullptr);
-   }
+      const auto matrix =
+         mtransform->getMatrix() *
+         osg::Matrix::rotate(0.0175 * mouse_delta.x(), 0.0, 0.0, 1.0);
+      
+      mtransform->setMatrix(
+         matrix);
 
-   void subload(
-      const osg::Texture2D & texture,
-      osg::State & state) const override
-   {
-      load(
-         texture,
-         state);
+      Invalidate();
    }
 
-private:
-   bool performing_resize_ { false };
-
-};
+   previous_mouse_pos_ =
+      position;
+}
 
-void OSGView::SetupFrameBuffer(
-   const Multisample multisample ) noexcept
+void OSGView::OnPresentComplete(
+   const std::shared_ptr<
+      std::pair< ColorBuffer, gl::FenceSync > > & fence_sync ) noexcept
 {
-   graphics_context_->makeCurrent();
+   swap_chain_->Release(
+      fence_sync->first);
 
-   const auto depth_buffer =
-      SetupDepthBuffer(multisample);
+   completed_frames_.push_back(
+      fence_sync);
+}
 
-   const auto multisample_buffer =
-      SetupMultisampleBuffer(multisample);
+void OSGView::SetCameraLookAt(
+   const std::array< double, 3 > & eye,
+   const std::array< double, 3 > & center,
+   const std::array< double, 3 > & up ) noexcept
+{
+   osg_scene_view_->getCamera()->setViewMatrix(
+      osg::Matrix::lookAt(
+         osg::Vec3d { eye[0], eye[1], eye[2] },
+         osg::Vec3d { center[0], center[1], center[2] },
+         osg::Vec3d { up[0], up[1], up[2] }));
 
-   if (multisample_buffer)
+   Invalidate();
+}
+
+class TimerQueryMarkCallback :
+   public osg::Camera::DrawCallback
+{
+public:
+   explicit TimerQueryMarkCallback(
+      gl::TimerQuery & timer_query ) :
+   timer_query_ { timer_query }
    {
-#if !USE_SINGLE_DEPTH_STENCIL_MULTISAMPLE_ATTACHMENT
-      const auto stencil_buffer =
-         SetupStencilBuffer(multisample);
-#endif
+   }
 
-      multisample_frame_buffer_ =
-         new osg::FrameBufferObject;
+   void operator () (
+      osg::RenderInfo & ) const override
+   {
+      timer_query_.Mark();
+   }
 
-      multisample_frame_buffer_->setAttachment(
-         osg::FrameBufferObject::BufferComponent::COLOR_BUFFER0,
-         osg::FrameBufferAttachment { multisample_buffer });
+private:
+   gl::TimerQuery & timer_query_;
 
-#if USE_SINGLE_DEPTH_STENCIL_MULTISAMPLE_ATTACHMENT
-      multisample_frame_buffer_->setAttachment(
-         osg::FrameBufferObject::BufferComponent::PACKED_DEPTH_STENCIL_BUFFER,
-         osg::FrameBufferAttachment {
-            static_cast< osg::Texture2DMultisample * >(
-               depth_buffer.get()) });
-#else
-      multisample_frame_buffer_->setAttachment(
-         osg::FrameBufferObject::BufferComponent::DEPTH_BUFFER,
-         osg::FrameBufferAttachment {
-            static_cast< osg::Texture2DMultisample * >(
-               depth_buffer.get()) });
-      multisample_frame_buffer_->setAttachment(
-         osg::FrameBufferObject::BufferComponent::STENCIL_BUFFER,
-         osg::FrameBufferAttachment {
-            stencil_buffer });
-#endif
+};
 
-      multisample_frame_buffer_->apply(
-         *graphics_context_->getState());
+// installed as the update and cull callback of the group holding the
+// model, so a model with update callbacks is traversed by one view
+// at a time.  views of static models traverse them without locking.
+class ModelTraversalLockCallback :
+   public osg::NodeCallback
+{
+public:
+   void operator () (
+      osg::Node * const node,
+      osg::NodeVisitor * const node_visitor ) override
+   {
+      const auto model_group =
+         node->asGroup();
+
+      if (model_group->getNumChildren())
+      {
+         const auto model_traversal_lock =
+            model_loader::LockModelTraversal(
+               *model_group->getChild(0));
 
-      osg_scene_view_->getRenderStage()->setFrameBufferObject(
-         multisample_frame_buffer_);
+         traverse(
+            node,
+            node_visitor);
+      }
+   }
+
+};
+
+void OSGView::SetupOSG(
+   const std::string & model ) noexcept
+{
+   if (!graphics_context_->getState()->get< osg::GLExtensions >())
+   {
+      graphics_context_->makeCurrent();
+      graphics_context_->getState()->initializeExtensionProcs();
+      graphics_context_->releaseContext();
    }
 
-   for (size_t i { 0 }; i < 3; ++i)
+   // textures are allocated once with glTexStorage and replaced
+   // instead of respecified, so the driver never has to revalidate
+   // a render target that changed size or mip levels underneath it
+   graphics_context_->getState()->get< osg::GLExtensions >(
+      )->isTextureStorageEnabled =
+         USE_IMMUTABLE_TEXTURE_STORAGE &&
+         graphics_context_->getState()->get< osg::GLExtensions >(
+            )->isTextureStorageEnabled;
+
+   for (const auto & scene_view : { osg_scene_view_, draw_scene_view_ })
    {
-      osg::ref_ptr< osg::Texture2D > color_buffer {
-         new osg::Texture2D };
-
-      color_buffer->setTextureSize(width_, height_);
-      color_buffer->setInternalFormat(GL_RGBA8);
-      color_buffer->setSourceFormat(GL_RGBA);
-      color_buffer->setSourceType(GL_UNSIGNED_BYTE);
-      color_buffer->setWrap(
-         osg::Texture::WrapParameter::WRAP_S,
-         osg::Texture::WrapMode::CLAMP_TO_EDGE);
-      color_buffer->setWrap(
-         osg::Texture::WrapParameter::WRAP_T,
-         osg::Texture::WrapMode::CLAMP_TO_EDGE);
-      color_buffer->setFilter(
-         osg::Texture::FilterParameter::MIN_FILTER,
-         osg::Texture::FilterMode::NEAREST);
-      color_buffer->setFilter(
-         osg::Texture::FilterParameter::MAG_FILTER,
-         osg::Texture::FilterMode::NEAREST);
-      color_buffer->setResizeNonPowerOfTwoHint(false);
+      scene_view->setDefaults();
 
-      color_buffer->setSubloadCallback(
-         new FrameBufferSubloadCallback);
+      scene_view->setState(
+         graphics_context_->getState());
 
-      osg::ref_ptr< osg::FrameBufferObject > frame_buffer {
-         new osg::FrameBufferObject };
+      scene_view->setUpdateVisitor(
+         new osgUtil::UpdateVisitor);
 
-      frame_buffer->setAttachment(
-         osg::FrameBufferObject::BufferComponent::COLOR_BUFFER0,
-         osg::FrameBufferAttachment { color_buffer });
+      scene_view->setAutomaticFlush(true);
+
+      scene_view->setRenderStage(
+         new osgUtil::RenderStage);
+   }
+
+   incremental_compile_ =
+      new osgUtil::IncrementalCompileOperation;
+
+   // a target frame rate this high leaves no spare frame time,
+   // so the budget alone limits the time spent compiling
+   incremental_compile_->setTargetFrameRate(
+      1.0e6);
+   incremental_compile_->setMinimumTimeAvailableForGLCompileAndDeletePerFrame(
+      std::chrono::duration< double > { GL_COMPILE_TIME_BUDGET }.count());
+   incremental_compile_->setMaximumNumOfObjectsToCompilePerFrame(
+      std::numeric_limits< unsigned int >::max());
+
+   compiled_model_ =
+      new osg::Group;
+
+   // the model is read by the model loader and swapped in
+   // for the placeholder once it is loaded and compiled
+   pending_model_ =
+      model_loader::Load(
+         model);
+
+   const auto placeholder {
+      new osg::Geode };
 
-      if (!multisample_buffer)
+   placeholder->addDrawable(
+      new osg::ShapeDrawable {
+         new osg::Box { osg::Vec3 { }, 1.0f } });
+
+   model_group_ =
+      new osg::Group;
+
+   model_group_->addChild(
+      placeholder);
+
+   const auto mtransform =
+      new osg::MatrixTransform;
+
+   mtransform->addChild(
+      model_group_);
+
+   const auto text_ortho_projection {
+      new osg::Projection {
+         osg::Matrix::ortho(
+            0.0, width_,
+            0.0, height_,
+            -1.0, 1.0) } };
+   
+   text_ortho_projection->addChild(
+      new osgText::Text);
+
+   const auto rotate_to_screen {
+      new osg::AutoTransform };
+
+   rotate_to_screen->setAutoRotateMode(
+      osg::AutoTransform::ROTATE_TO_SCREEN);
+
+   rotate_to_screen->addChild(
+      text_ortho_projection);
+
+   mtransform->addChild(
+      rotate_to_screen);
+
+   const osg::ref_ptr< osg::FrameStamp > frame_stamp {
+      new osg::FrameStamp };
+
+   for (const auto & scene_view : { osg_scene_view_, draw_scene_view_ })
+   {
+      scene_view->setSceneData(
+         mtransform);
+
+      scene_view->setFrameStamp(
+         frame_stamp);
+   }
+
+   osg_scene_view_->getCamera()->setProjectionMatrix(
+      osg::Matrix::perspective(
+         45.0,
+         static_cast< double >(width_) /
+         static_cast< double >(height_),
+         1.0, 200.0));
+
+   osg_scene_view_->getViewport()->setViewport(
+      0.0, 0.0,
+      width_, height_);
+
+#if USE_GPU_TIMER_QUERIES
+   // the render stage is not given the color buffer to resolve to,
+   // as it would resolve before the post draw callback of the camera.
+   // the view resolves the frame once the final draw callback marked
+   // the end of the geometry and marks the end of the resolve itself.
+   for (const auto & scene_view : { osg_scene_view_, draw_scene_view_ })
+   {
+      const auto camera =
+         scene_view->getCamera();
+
+      camera->setInitialDrawCallback(
+         new TimerQueryMarkCallback { *draw_timer_ });
+      camera->setFinalDrawCallback(
+         new TimerQueryMarkCallback { *draw_timer_ });
+   }
+#endif
+
+   // init queries the gl extensions, so it cannot
+   // be left to the first cull on a worker thread
+   graphics_context_->makeCurrent();
+
+   for (const auto & scene_view : { osg_scene_view_, draw_scene_view_ })
+   {
+      scene_view->init();
+   }
+
+   graphics_context_->releaseContext();
+}
+
+void OSGView::SetupFrameBuffer(
+   const Multisample multisample ) noexcept
+{
+   graphics_context_->makeCurrent();
+
+   const auto gl_objects_lock =
+      gl_objects::Lock(
+         graphics_context_->getState()->getContextID());
+
+   // only the color buffers of a view that is not multisampled
+   // have a depth buffer attached, so they are replaced when
+   // multisampling is turned on or off
+   const bool replace_color_buffers {
+      !swap_chain_ ||
+      (multisample == Multisample::NONE) !=
+      (multisample_ == Multisample::NONE) };
+
+   multisample_ = multisample;
+
+#if !USE_SHARED_MULTISAMPLE_TARGETS
+   // a pending frame holds on to the previous buffer until drawn
+   multisample_frame_buffer_ =
+      CreateMultisampleFrameBuffer(
+         CreateMultisampleAttachments(
+            target_width_,
+            target_height_,
+            multisample));
+#endif
+
+   if (replace_color_buffers)
+   {
+      // without multisampling the color buffers share one depth buffer
+      color_depth_buffer_ =
+         multisample == Multisample::NONE ?
+         SetupDepthBuffer(multisample, target_width_, target_height_) :
+         osg::ref_ptr< osg::Texture > { };
+
+      if (swap_chain_)
       {
-         frame_buffer->setAttachment(
-            osg::FrameBufferObject::BufferComponent::PACKED_DEPTH_STENCIL_BUFFER,
-            osg::FrameBufferAttachment {
-               static_cast< osg::Texture2D * >(
-                  depth_buffer.get()) });
+         // the consumer may still hold on to presented buffers
+         swap_chain_->Retire();
+      }
+      else
+      {
+         swap_chain_.reset(
+            new SwapChain {
+               [ this ] ( )
+               {
+                  return
+                     CreateColorFrameBuffer(
+                        color_depth_buffer_);
+               },
+               SWAP_CHAIN_MINIMUM_DEPTH,
+               SWAP_CHAIN_MAXIMUM_DEPTH });
       }
 
-      frame_buffer->apply(
-         *graphics_context_->getState());
+      swap_chain_->Fill();
+   }
 
-      const auto & color0_attachment =
-         frame_buffer->getAttachment(
-            osg::FrameBufferObject::BufferComponent::COLOR_BUFFER0);
-      const auto color_buffer_texture_object =
-         color0_attachment.getTexture()->getTextureObject(
-            graphics_context_->getState()->getContextID());
-      
-      inactive_frame_buffers_.emplace(
-         color_buffer_texture_object->id(),
-         frame_buffer);
+   graphics_context_->releaseContext();
+}
 
-      std::cout
-         << "Color ID = "
-         << color_buffer_texture_object->id()
-         << std::endl;
+std::pair< ColorBuffer, osg::ref_ptr< osg::FrameBufferObject > >
+OSGView::CreateColorFrameBuffer(
+   const osg::ref_ptr< osg::Texture > & depth_buffer ) noexcept
+{
+   osg::ref_ptr< osg::FrameBufferObject > frame_buffer {
+      new osg::FrameBufferObject };
+
+#if USE_COLOR_BUFFER_ARRAY
+   // the views sharing the context id share the texture arrays.
+   // no other view creates color buffers for a context id of its
+   // own, so a texture array then holds no more layers than the swap
+   // chain keeps.  a chain growing past it adds another array.
+   const uint32_t layers_per_texture_array {
+      gl_objects::IsSharedContextID(
+         graphics_context_->getState()->getContextID()) ?
+      SHARED_COLOR_BUFFER_ARRAY_LAYERS :
+      static_cast< uint32_t >(
+         swap_chain_ ?
+         swap_chain_->MinimumDepth() :
+         SWAP_CHAIN_MINIMUM_DEPTH) };
+
+   const auto color_buffer_layer =
+      color_buffer_pool::Acquire(
+         graphics_context_->getState()->getContextID(),
+         target_width_,
+         target_height_,
+         GL_RGBA8,
+         layers_per_texture_array);
+
+   frame_buffer->setAttachment(
+      osg::FrameBufferObject::BufferComponent::COLOR_BUFFER0,
+      osg::FrameBufferAttachment {
+         &color_buffer_layer->TextureArray(),
+         color_buffer_layer->Index() });
+
+   // the layer returns to the pool along with the frame buffer
+   frame_buffer->setUserData(
+      color_buffer_layer.get());
+#else
+   osg::ref_ptr< osg::Texture2D > color_buffer {
+      new osg::Texture2D };
+
+   color_buffer->setTextureSize(target_width_, target_height_);
+   color_buffer->setInternalFormat(GL_RGBA8);
+   color_buffer->setSourceFormat(GL_RGBA);
+   color_buffer->setSourceType(GL_UNSIGNED_BYTE);
+   color_buffer->setWrap(
+      osg::Texture::WrapParameter::WRAP_S,
+      osg::Texture::WrapMode::CLAMP_TO_EDGE);
+   color_buffer->setWrap(
+      osg::Texture::WrapParameter::WRAP_T,
+      osg::Texture::WrapMode::CLAMP_TO_EDGE);
+   color_buffer->setFilter(
+      osg::Texture::FilterParameter::MIN_FILTER,
+      osg::Texture::FilterMode::NEAREST);
+   color_buffer->setFilter(
+      osg::Texture::FilterParameter::MAG_FILTER,
+      osg::Texture::FilterMode::NEAREST);
+   color_buffer->setResizeNonPowerOfTwoHint(false);
+
+   frame_buffer->setAttachment(
+      osg::FrameBufferObject::BufferComponent::COLOR_BUFFER0,
+      osg::FrameBufferAttachment { color_buffer });
+#endif
+
+   if (depth_buffer)
+   {
+      frame_buffer->setAttachment(
+         osg::FrameBufferObject::BufferComponent::PACKED_DEPTH_STENCIL_BUFFER,
+         osg::FrameBufferAttachment {
+            static_cast< osg::Texture2D * >(
+               depth_buffer.get()) });
    }
 
-   graphics_context_->releaseContext();
+   frame_buffer->apply(
+      *graphics_context_->getState());
+
+   const auto & color0_attachment =
+      frame_buffer->getAttachment(
+         osg::FrameBufferObject::BufferComponent::COLOR_BUFFER0);
+   const auto color_buffer_texture_object =
+      color0_attachment.getTexture()->getTextureObject(
+         graphics_context_->getState()->getContextID());
+   
+   const ColorBuffer color_buffer_id {
+      color_buffer_texture_object->id(),
+#if USE_COLOR_BUFFER_ARRAY
+      static_cast< GLint >(color_buffer_layer->Index())
+#else
+      -1
+#endif
+   };
+
+   return
+      std::make_pair(
+         color_buffer_id,
+         frame_buffer);
 }
 
 void OSGView::SetupSignalsSlots( ) noexcept
@@ -752,22 +1486,11 @@ void OSGView::SetupSignalsSlots( ) noexcept
       &parent_,
       SIGNAL(PresentComplete(
          const std::shared_ptr<
-            std::pair< GLuint, gl::FenceSync > > &)),
+            std::pair< ColorBuffer, gl::FenceSync > > &)),
       this,
       SLOT(OnPresentComplete(
          const std::shared_ptr<
-            std::pair< GLuint, gl::FenceSync > > &)));
-   QObject::connect(
-      &parent_,
-      SIGNAL(SetCameraLookAt(
-         const std::array< double, 3 > &,
-         const std::array< double, 3 > &,
-         const std::array< double, 3 > &)),
-      this,
-      SLOT(OnSetCameraLookAt(
-         const std::array< double, 3 > &,
-         const std::array< double, 3 > &,
-         const std::array< double, 3 > &)));
+            std::pair< ColorBuffer, gl::FenceSync > > &)));
 }
 
 void OSGView::ReleaseSignalsSlots( ) noexcept
@@ -781,31 +1504,248 @@ void OSGView::ReleaseSignalsSlots( ) noexcept
       &parent_,
       SIGNAL(PresentComplete(
          const std::shared_ptr<
-            std::pair< GLuint, gl::FenceSync > > &)),
+            std::pair< ColorBuffer, gl::FenceSync > > &)),
       this,
       SLOT(OnPresentComplete(
          const std::shared_ptr<
-            std::pair< GLuint, gl::FenceSync > > &)));
-   QObject::disconnect(
-      &parent_,
-      SIGNAL(SetCameraLookAt(
-         const std::array< double, 3 > &,
-         const std::array< double, 3 > &,
-         const std::array< double, 3 > &)),
-      this,
-      SLOT(OnSetCameraLookAt(
-         const std::array< double, 3 > &,
-         const std::array< double, 3 > &,
-         const std::array< double, 3 > &)));
+            std::pair< ColorBuffer, gl::FenceSync > > &)));
 }
 
 #define GL_DEPTH_STENCIL 0x84F9
 #define GL_DEPTH32F_STENCIL8 0x8CAD
 #define GL_FLOAT_32_UNSIGNED_INT_24_8_REV 0x8DAD
 
+render_target_pool::Attachments
+OSGView::CreateMultisampleAttachments(
+   const uint32_t width,
+   const uint32_t height,
+   const Multisample multisample ) noexcept
+{
+   render_target_pool::Attachments attachments;
+
+   if (multisample != Multisample::NONE)
+   {
+      attachments.emplace_back(
+         osg::FrameBufferObject::BufferComponent::COLOR_BUFFER0,
+         SetupMultisampleBuffer(multisample, width, height));
+
+#if USE_SINGLE_DEPTH_STENCIL_MULTISAMPLE_ATTACHMENT
+      attachments.emplace_back(
+         osg::FrameBufferObject::BufferComponent::PACKED_DEPTH_STENCIL_BUFFER,
+         SetupDepthBuffer(multisample, width, height));
+#else
+      attachments.emplace_back(
+         osg::FrameBufferObject::BufferComponent::DEPTH_BUFFER,
+         SetupDepthBuffer(multisample, width, height));
+      attachments.emplace_back(
+         osg::FrameBufferObject::BufferComponent::STENCIL_BUFFER,
+         SetupStencilBuffer(multisample, width, height));
+#endif
+   }
+
+   return attachments;
+}
+
+osg::ref_ptr< osg::FrameBufferObject >
+OSGView::CreateMultisampleFrameBuffer(
+   const render_target_pool::Attachments & attachments ) noexcept
+{
+   osg::ref_ptr< osg::FrameBufferObject > frame_buffer;
+
+   if (!attachments.empty())
+   {
+      frame_buffer =
+         new osg::FrameBufferObject;
+
+      // the attachments are all multisample textures
+      for (const auto & attachment : attachments)
+      {
+         frame_buffer->setAttachment(
+            attachment.first,
+            osg::FrameBufferAttachment {
+               static_cast< osg::Texture2DMultisample * >(
+                  attachment.second.get()) });
+      }
+
+      frame_buffer->apply(
+         *graphics_context_->getState());
+   }
+
+   return frame_buffer;
+}
+
+void OSGView::BorrowMultisampleTarget( ) noexcept
+{
+   // the frame is drawn at the size of the color buffer it resolves
+   // to, which the view may have been resized from since
+   const auto color_texture =
+      draw_resolve_frame_buffer_->getAttachment(
+         osg::FrameBufferObject::BufferComponent::COLOR_BUFFER0).getTexture();
+
+   const auto width =
+      static_cast< uint32_t >(color_texture->getTextureWidth());
+   const auto height =
+      static_cast< uint32_t >(color_texture->getTextureHeight());
+   const auto samples =
+      static_cast< uint32_t >(draw_multisample_);
+
+   if (multisample_target_ &&
+       (multisample_target_->Width() != width ||
+        multisample_target_->Height() != height ||
+        multisample_target_->Samples() != samples))
+   {
+      // the previous target is returned first, so it is freed
+      // before the next one is created when no other view holds it
+      render_target_pool::Return(
+         multisample_target_);
+
+      multisample_frame_buffer_ = nullptr;
+   }
+
+   if (!multisample_target_)
+   {
+      multisample_target_ =
+         render_target_pool::Borrow(
+            graphics_context_->getState()->getContextID(),
+            width,
+            height,
+            samples,
+            MULTISAMPLE_BYTES_PER_SAMPLE,
+            [ this ] (
+               const uint32_t target_width,
+               const uint32_t target_height,
+               const uint32_t target_samples )
+            {
+               return
+                  CreateMultisampleAttachments(
+                     target_width,
+                     target_height,
+                     static_cast< Multisample >(target_samples));
+            });
+
+      // frame buffer objects are not shared between contexts, so the
+      // view attaches the pooled textures to a frame buffer of its own
+      multisample_frame_buffer_ =
+         multisample_target_ ?
+         CreateMultisampleFrameBuffer(
+            multisample_target_->GetAttachments()) :
+         osg::ref_ptr< osg::FrameBufferObject > { };
+   }
+
+   if (multisample_target_)
+   {
+      multisample_target_->WaitForPreviousDraw();
+   }
+
+   draw_scene_view_->getRenderStage()->setFrameBufferObject(
+      multisample_frame_buffer_);
+}
+
+void OSGView::InvalidateFrameBuffer( ) noexcept
+{
+   const auto render_stage =
+      draw_scene_view_->getRenderStage();
+
+   // a multisampled frame is drawn to the multisample target and
+   // resolved to the color buffer.  otherwise the frame is drawn to
+   // the color buffer, where only the depth buffer is invalidated.
+   const auto frame_buffer =
+      render_stage->getFrameBufferObject();
+   const bool multisampled {
+      draw_resolve_frame_buffer_ != nullptr };
+
+   GLenum attachments[3] { };
+   GLsizei count { 0 };
+
+   if (multisampled && invalidate_multisample_color_)
+   {
+      attachments[count++] = GL_COLOR_ATTACHMENT0;
+   }
+
+   if (invalidate_depth_stencil_)
+   {
+#if USE_SINGLE_DEPTH_STENCIL_MULTISAMPLE_ATTACHMENT
+      attachments[count++] = GL_DEPTH_STENCIL_ATTACHMENT;
+#else
+      if (multisampled)
+      {
+         attachments[count++] = GL_DEPTH_ATTACHMENT;
+         attachments[count++] = GL_STENCIL_ATTACHMENT;
+      }
+      else
+      {
+         attachments[count++] = GL_DEPTH_STENCIL_ATTACHMENT;
+      }
+#endif
+   }
+
+   if (frame_buffer && count)
+   {
+      auto & state =
+         *graphics_context_->getState();
+
+      frame_buffer->apply(
+         state,
+         osg::FrameBufferObject::READ_DRAW_FRAMEBUFFER);
+
+      gl::InvalidateFrameBuffer(
+         GL_FRAMEBUFFER,
+         attachments,
+         count);
+
+      // the render stage leaves the default frame buffer bound
+      state.get< osg::GLExtensions >()->glBindFramebuffer(
+         GL_FRAMEBUFFER_EXT,
+         0);
+   }
+}
+
+void OSGView::ResolveFrame( ) noexcept
+{
+   const auto multisample_frame_buffer =
+      draw_scene_view_->getRenderStage()->getFrameBufferObject();
+
+   if (draw_resolve_frame_buffer_ && multisample_frame_buffer)
+   {
+      auto & state =
+         *graphics_context_->getState();
+
+      multisample_frame_buffer->apply(
+         state,
+         osg::FrameBufferObject::READ_FRAMEBUFFER);
+      draw_resolve_frame_buffer_->apply(
+         state,
+         osg::FrameBufferObject::DRAW_FRAMEBUFFER);
+
+      // the frame covers the lower left of both buffers
+      const auto viewport =
+         draw_scene_view_->getViewport();
+
+      const auto x0 = static_cast< GLint >(viewport->x());
+      const auto y0 = static_cast< GLint >(viewport->y());
+      const auto x1 = static_cast< GLint >(viewport->x() + viewport->width());
+      const auto y1 = static_cast< GLint >(viewport->y() + viewport->height());
+
+      const auto extensions =
+         state.get< osg::GLExtensions >();
+
+      extensions->glBlitFramebuffer(
+         x0, y0, x1, y1,
+         x0, y0, x1, y1,
+         GL_COLOR_BUFFER_BIT,
+         GL_NEAREST);
+
+      extensions->glBindFramebuffer(
+         GL_FRAMEBUFFER_EXT,
+         0);
+   }
+}
+
 osg::ref_ptr< osg::Texture >
 OSGView::SetupDepthBuffer(
-   const Multisample multisample ) noexcept
+   const Multisample multisample,
+   const uint32_t width,
+   const uint32_t height ) noexcept
 {
    assert(
       graphics_context_->isCurrent());
@@ -818,7 +1758,7 @@ OSGView::SetupDepthBuffer(
       const auto buffer =
          new osg::Texture2D;
 
-      buffer->setTextureSize(width_, height_);
+      buffer->setTextureSize(width, height);
 #if USE_SINGLE_DEPTH_STENCIL_MULTISAMPLE_ATTACHMENT
       buffer->setInternalFormat(GL_DEPTH32F_STENCIL8);
       buffer->setSourceFormat(GL_DEPTH_STENCIL);
@@ -829,9 +1769,6 @@ OSGView::SetupDepthBuffer(
       buffer->setSourceType(GL_FLOAT);
 #endif
 
-      buffer->setSubloadCallback(
-         new FrameBufferSubloadCallback);
-
       depth_buffer = buffer;
    }
    else
@@ -841,7 +1778,7 @@ OSGView::SetupDepthBuffer(
             static_cast< GLsizei >(multisample),
             GL_FALSE };
 
-      buffer->setTextureSize(width_, height_);
+      buffer->setTextureSize(width, height);
 #if USE_SINGLE_DEPTH_STENCIL_MULTISAMPLE_ATTACHMENT
       buffer->setInternalFormat(GL_DEPTH32F_STENCIL8);
       buffer->setSourceFormat(GL_DEPTH_STENCIL);
@@ -872,18 +1809,14 @@ OSGView::SetupDepthBuffer(
    depth_buffer->apply(
       *graphics_context_->getState());
 
-   std::cout
-      << "Depth ID = "
-      << depth_buffer->getTextureObject(
-            graphics_context_->getState()->getContextID())->id()
-      << std::endl;
-
    return depth_buffer;
 }
 
 osg::ref_ptr< osg::Texture2DMultisample >
 OSGView::SetupStencilBuffer(
-   const Multisample multisample ) noexcept
+   const Multisample multisample,
+   const uint32_t width,
+   const uint32_t height ) noexcept
 {
    assert(
       graphics_context_->isCurrent());
@@ -898,7 +1831,7 @@ OSGView::SetupStencilBuffer(
             static_cast< GLsizei >(multisample),
             GL_FALSE };
 
-      stencil_buffer->setTextureSize(width_, height_);
+      stencil_buffer->setTextureSize(width, height);
       stencil_buffer->setInternalFormat(GL_STENCIL_INDEX8_EXT);
       stencil_buffer->setSourceFormat(GL_STENCIL_INDEX);
       stencil_buffer->setSourceType(GL_UNSIGNED_BYTE);
@@ -918,12 +1851,6 @@ OSGView::SetupStencilBuffer(
 
       stencil_buffer->apply(
          *graphics_context_->getState());
-      
-      std::cout
-         << "Stencil ID = "
-         << stencil_buffer->getTextureObject(
-               graphics_context_->getState()->getContextID())->id()
-         << std::endl;
    }
 
    return stencil_buffer;
@@ -931,7 +1858,9 @@ OSGView::SetupStencilBuffer(
 
 osg::ref_ptr< osg::Texture2DMultisample >
 OSGView::SetupMultisampleBuffer(
-   const Multisample multisample ) noexcept
+   const Multisample multisample,
+   const uint32_t width,
+   const uint32_t height ) noexcept
 {
    assert(
       graphics_context_->isCurrent());
@@ -946,7 +1875,7 @@ OSGView::SetupMultisampleBuffer(
             static_cast< GLsizei >(multisample),
             GL_FALSE };
 
-      multisample_buffer->setTextureSize(width_, height_);
+      multisample_buffer->setTextureSize(width, height);
       multisample_buffer->setInternalFormat(GL_RGBA8);
       multisample_buffer->setSourceFormat(GL_RGBA);
       multisample_buffer->setSourceType(GL_UNSIGNED_BYTE);
@@ -966,19 +1895,125 @@ OSGView::SetupMultisampleBuffer(
 
       multisample_buffer->apply(
          *graphics_context_->getState());
-      
-      std::cout
-         << "Multisample ID = "
-         << multisample_buffer->getTextureObject(
-               graphics_context_->getState()->getContextID())->id()
-         << std::endl;
    }
 
    return multisample_buffer;
 }
 
+void OSGView::UpdateModel( ) noexcept
+{
+   if (pending_model_.valid() &&
+       pending_model_.wait_for(std::chrono::seconds { 0 }) ==
+       std::future_status::ready)
+   {
+      const auto model_node =
+         pending_model_.get();
+
+      if (model_node)
+      {
+#if USE_INCREMENTAL_GL_COMPILE
+         // the model is compiled over several frames and only
+         // attached to the compiled model group once complete
+         osgUtil::IncrementalCompileOperation::ContextSet contexts {
+            graphics_context_.get() };
+
+         const auto compile_set =
+            new osgUtil::IncrementalCompileOperation::CompileSet {
+               compiled_model_.get(),
+               model_node.get() };
+
+         compile_set->buildCompileMap(
+            contexts);
+
+         incremental_compile_->add(
+            compile_set,
+            false);
+
+         compiling_model_ = true;
+#else
+         const auto model_parents_lock =
+            model_loader::LockModelParents();
+
+         AttachModel(
+            *model_node);
+#endif
+      }
+
+      pending_model_ =
+         decltype(pending_model_) { };
+
+      Invalidate();
+   }
+}
+
+void OSGView::CompileModel( ) noexcept
+{
+   if (compiling_model_)
+   {
+      const auto compile_start =
+         std::chrono::steady_clock::now();
+
+      (*incremental_compile_)(
+         graphics_context_.get());
+
+      // merging attaches the model to the compiled model group
+      const auto model_parents_lock =
+         model_loader::LockModelParents();
+
+      incremental_compile_->mergeCompiledSubgraphs(
+         osg_scene_view_->getFrameStamp());
+
+      telemetry::Record(
+         telemetry::Phase::VIEW_COMPILE,
+         std::chrono::steady_clock::now() - compile_start,
+         this);
+
+      if (compiled_model_->getNumChildren())
+      {
+         AttachModel(
+            *compiled_model_->getChild(0));
+
+         compiled_model_->removeChildren(
+            0,
+            compiled_model_->getNumChildren());
+
+         compiling_model_ = false;
+
+         Invalidate();
+      }
+   }
+}
+
+void OSGView::AttachModel(
+   osg::Node & model ) noexcept
+{
+   // the caller holds the lock on the parents of the models
+   retired_model_ =
+      model_group_->getChild(0);
+
+   model_group_->setChild(
+      0,
+      &model);
+
+   // the culls of other views must not read the model while its
+   // update callbacks change it
+   const bool model_updates {
+      model.getUpdateCallback() ||
+      model.getNumChildrenRequiringUpdateTraversal() };
+
+   const osg::ref_ptr< osg::NodeCallback > model_traversal_lock {
+      model_updates ?
+      new ModelTraversalLockCallback :
+      nullptr };
+
+   model_group_->setUpdateCallback(
+      model_traversal_lock);
+   model_group_->setCullCallback(
+      model_traversal_lock);
+}
+
 void OSGView::UpdateText(
-   const GLuint color_buffer_texture_id ) const noexcept
+   const ColorBuffer & color_buffer ) const noexcept
 {
    const auto scene_data =
       osg_scene_view_->getSceneData();
@@ -995,7 +2030,10 @@ void OSGView::UpdateText(
          text_node->getText().createUTF8EncodedString() };
 
       text =
-         std::to_string(color_buffer_texture_id) +
+         std::to_string(color_buffer.texture_id) +
+         (color_buffer.layer < 0 ?
+          std::string { } :
+          ":" + std::to_string(color_buffer.layer)) +
          "  " +
          text;
 
@@ -1026,39 +2064,77 @@ void OSGView::UpdateTextProjection( ) const noexcept
    }
 }
 
-std::pair< bool, GLuint > OSGView::SetupNextFrame( ) noexcept
+std::pair< bool, ColorBuffer > OSGView::SetupNextFrame( ) noexcept
 {
-   std::pair< bool, GLuint > setup { false, 0 };
+   std::pair< bool, ColorBuffer > setup { false, ColorBuffer { } };
 
-   const auto frame_buffer =
-      GetNextFrameBuffer();
+   auto frame_buffer =
+      swap_chain_->Acquire();
 
-   if (frame_buffer.second)
+   const bool resize {
+      frame_buffer.second &&
+      (frame_buffer.second->getAttachment(
+         osg::FrameBufferObject::BufferComponent::COLOR_BUFFER0
+         ).getTexture()->getTextureWidth() != target_width_ ||
+       frame_buffer.second->getAttachment(
+         osg::FrameBufferObject::BufferComponent::COLOR_BUFFER0
+         ).getTexture()->getTextureHeight() != target_height_) };
+
+   if (resize)
    {
-      const auto color_texture =
-         const_cast< osg::Texture2D * >(
-            static_cast< const osg::Texture2D * >(
-               frame_buffer.second->getAttachment(
-                  osg::FrameBufferObject::BufferComponent::COLOR_BUFFER0).getTexture()));
-
-      if (color_texture->getTextureWidth() != width_ ||
-          color_texture->getTextureHeight() != height_)
+      // immutable storage and the layers of a texture array cannot
+      // be resized, so the buffers of the previous size are replaced
+      // by new ones of the current size.  the buffers the consumer
+      // holds on to and the pending frame keep their textures alive.
+      swap_chain_->Release(
+         frame_buffer.first);
+
+      if (multisample_ == Multisample::NONE)
       {
-         const auto subload_callback =
-            static_cast< FrameBufferSubloadCallback * >(
-               color_texture->getSubloadCallback());
+         color_depth_buffer_ =
+            SetupDepthBuffer(
+               multisample_,
+               target_width_,
+               target_height_);
+      }
 
-         subload_callback->SetPerformingResize(true);
+      swap_chain_->Retire();
 
-         color_texture->setTextureSize(
-            width_,
-            height_);
+      frame_buffer =
+         swap_chain_->Acquire();
+   }
 
-         color_texture->apply(
-            *graphics_context_->getState());
+#if !USE_SHARED_MULTISAMPLE_TARGETS
+   if (multisample_frame_buffer_)
+   {
+      const auto multisample_color_texture =
+         multisample_frame_buffer_->getAttachment(
+            osg::FrameBufferObject::BufferComponent::COLOR_BUFFER0).getTexture();
 
-         subload_callback->SetPerformingResize(false);
+      if (multisample_color_texture->getTextureWidth() != target_width_ ||
+          multisample_color_texture->getTextureHeight() != target_height_)
+      {
+         multisample_frame_buffer_ =
+            CreateMultisampleFrameBuffer(
+               CreateMultisampleAttachments(
+                  target_width_,
+                  target_height_,
+                  multisample_));
+      }
+   }
+#endif
 
+   if (frame_buffer.second)
+   {
+      // the frame covers the lower left of a buffer that is only
+      // reallocated when the view leaves the size bucket of the
+      // buffer, so the viewport follows the view every frame
+      const auto viewport =
+         osg_scene_view_->getViewport();
+
+      if (viewport->width() != render_width_ ||
+          viewport->height() != render_height_)
+      {
          osg_scene_view_->getCamera()->setProjectionMatrix(
             osg::Matrix::perspective(
                45.0,
@@ -1066,159 +2142,39 @@ std::pair< bool, GLuint > OSGView::SetupNextFrame( ) noexcept
                static_cast< double >(height_),
                1.0, 200.0));
 
-         osg_scene_view_->getViewport()->setViewport(
+         viewport->setViewport(
             0.0, 0.0,
-            width_, height_);
-      }
-
-      if (multisample_frame_buffer_)
-      {
-         const auto multisample_color_texture =
-         const_cast< osg::Texture2DMultisample * >(
-            static_cast< const osg::Texture2DMultisample * >(
-               multisample_frame_buffer_->getAttachment(
-                  osg::FrameBufferObject::BufferComponent::COLOR_BUFFER0).getTexture()));
-
-         if (multisample_color_texture->getTextureWidth() != width_ ||
-             multisample_color_texture->getTextureHeight() != height_)
-         {
-            multisample_color_texture->setTextureSize(
-               width_,
-               height_);
-
-            multisample_color_texture->apply(
-               *graphics_context_->getState());
-
-            graphics_context_->getState()->get< osg::GLExtensions >(
-               )->glTexImage2DMultisample(
-                     multisample_color_texture->getTextureTarget(),
-                     multisample_color_texture->getNumSamples(),
-                     multisample_color_texture->getInternalFormat(),
-                     width_, height_,
-#if OSG_VERSION_GREATER_OR_EQUAL(3, 5, 6)
-                     multisample_color_texture->getFixedSampleLocations());
-#else
-                     GL_FALSE);
-#endif
-         }
+            render_width_, render_height_);
       }
 
-      if (multisample_frame_buffer_)
+      // the render stages are setup every frame, as the scene view
+      // drawn next may have been prepared at another multisample level
+      if (multisample_ != Multisample::NONE)
       {
-#if USE_SINGLE_DEPTH_STENCIL_MULTISAMPLE_ATTACHMENT
-         const osg::FrameBufferObject::BufferComponent attachments[] {
-            osg::FrameBufferObject::BufferComponent::PACKED_DEPTH_STENCIL_BUFFER
-         };
-#else
-         const osg::FrameBufferObject::BufferComponent attachments[] {
-            osg::FrameBufferObject::BufferComponent::DEPTH_BUFFER,
-            osg::FrameBufferObject::BufferComponent::STENCIL_BUFFER
-         };
-#endif
-
-         for (const auto attachment : attachments)
-         {
-            const auto attachment_texture =
-               const_cast< osg::Texture2DMultisample * >(
-                  static_cast< const osg::Texture2DMultisample* >(
-                     multisample_frame_buffer_->getAttachment(
-                        attachment).getTexture()));
-            
-            if (attachment_texture->getTextureWidth() != width_ ||
-                attachment_texture->getTextureHeight() != height_)
-            {
-               attachment_texture->setTextureSize(
-                  width_,
-                  height_);
-            
-               attachment_texture->apply(
-                  *graphics_context_->getState());
-
-               graphics_context_->getState()->get< osg::GLExtensions >(
-                  )->glTexImage2DMultisample(
-                        attachment_texture->getTextureTarget(),
-                        attachment_texture->getNumSamples(),
-                        attachment_texture->getInternalFormat(),
-                        width_, height_,
-#if OSG_VERSION_GREATER_OR_EQUAL(3, 5, 6)
-                        attachment_texture->getFixedSampleLocations());
-#else
-                        GL_FALSE);
+#if !USE_SHARED_MULTISAMPLE_TARGETS
+         osg_scene_view_->getRenderStage()->setFrameBufferObject(
+            multisample_frame_buffer_);
 #endif
-            }
-         }
+         frame_resolve_frame_buffer_ =
+            frame_buffer.second;
       }
       else
       {
-         const auto depth_buffer =
-            const_cast< osg::Texture2D * >(
-               static_cast< const osg::Texture2D * >(
-                  frame_buffer.second->getAttachment(
-                     osg::FrameBufferObject::BufferComponent::PACKED_DEPTH_STENCIL_BUFFER).getTexture()));
-         
-         if (depth_buffer->getTextureWidth() != width_ ||
-             depth_buffer->getTextureHeight() != height_)
-         {
-            const auto subload_callback =
-               static_cast< FrameBufferSubloadCallback * >(
-                  depth_buffer->getSubloadCallback());
-         
-            subload_callback->SetPerformingResize(true);
-         
-            depth_buffer->setTextureSize(
-               width_,
-               height_);
-         
-            depth_buffer->apply(
-               *graphics_context_->getState());
-         
-            subload_callback->SetPerformingResize(false);
-         }
-      }
-
-      if (multisample_frame_buffer_)
-         osg_scene_view_->getRenderStage()->setMultisampleResolveFramebufferObject(
-            frame_buffer.second);
-      else
+         frame_resolve_frame_buffer_ =
+            nullptr;
          osg_scene_view_->getRenderStage()->setFrameBufferObject(
             frame_buffer.second);
+      }
 
       setup.first = true;
       setup.second = frame_buffer.first;
+      setup.second.width = static_cast< GLsizei >(render_width_);
+      setup.second.height = static_cast< GLsizei >(render_height_);
    }
 
    return setup;
 }
 
-std::pair< GLuint, osg::ref_ptr< osg::FrameBufferObject > >
-OSGView::GetNextFrameBuffer( ) noexcept
-{
-   std::pair< GLuint, osg::ref_ptr< osg::FrameBufferObject > >
-      frame_buffer { 0, nullptr };
-
-   if (!inactive_frame_buffers_.empty())
-   {
-      const auto frame_buffer_it = inactive_frame_buffers_.cbegin();
-      frame_buffer.first = frame_buffer_it->first;
-      frame_buffer.second = frame_buffer_it->second;
-
-#if _has_cxx_std_map_extract
-      active_frame_buffers_.insert(
-         inactive_frame_buffers_.extract(
-            frame_buffer_it->first));
-#else
-      active_frame_buffers_.insert({
-         frame_buffer_it->first,
-         frame_buffer_it->second});
-
-      inactive_frame_buffers_.erase(
-         frame_buffer_it);
-#endif
-   }
-
-   return frame_buffer;
-}
-
 void OSGView::OnResize(
    const int32_t width,
    const int32_t height ) noexcept
@@ -1227,6 +2183,8 @@ void OSGView::OnResize(
    height_ = static_cast< uint32_t >(height);
 
    UpdateTextProjection();
+
+   Invalidate();
 }
 
 #include <moc_osg-view.cpp>
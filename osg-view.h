@@ -1,6 +1,11 @@
 #ifndef _OSG_VIEW_H_
 #define _OSG_VIEW_H_
 
+#include "color-buffer.h"
+#include "multisample-governor.h"
+#include "render-scale-governor.h"
+#include "render-target-pool.h"
+
 #include <QtCore/QObject>
 #include <QtCore/QPoint>
 
@@ -23,19 +28,25 @@
 #endif
 
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <future>
 #include <map>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
-class QEvent;
+class SwapChain;
+struct SwapChainStatistics;
 
 namespace osg
 {
 class FrameBufferObject;
 class GraphicsContext;
+class Group;
+class Node;
 class Texture;
 class Texture2D;
 class Texture2DMultisample;
@@ -43,15 +54,16 @@ class Texture2DMultisample;
 
 namespace osgUtil
 {
+class IncrementalCompileOperation;
 class SceneView;
 }
 
 namespace gl
 {
 class FenceSync;
+class TimerQuery;
 }
 
-enum class Multisample;
 
 class OSGView :
    public QObject
@@ -71,14 +83,67 @@ public:
    void Render( ) noexcept;
    void PostRender( ) noexcept;
 
+   // render split into stages.  the update and cull stages do not use
+   // the context of the view, so the updates and culls of several
+   // views can run on other threads in between the prepare and draw
+   // stages.  the view double buffers its scene views, so a swapped
+   // frame can be drawn while the next one is prepared and culled, but
+   // the update changes the scene graph the drawn frame shares and
+   // has to finish before drawing.  update, cull and swap do nothing
+   // when the prepare stage did not setup a frame.
+   bool PrepareFrame( ) noexcept;
+   void UpdateFrame( ) noexcept;
+   void CullFrame( ) noexcept;
+   void SwapFrame( ) noexcept;
+   void DrawFrame( ) noexcept;
+   // a culled frame has been swapped in and waits to be drawn
+   bool FramePending( ) const noexcept;
+
+   // when rendering on demand a view is only rendered after it has
+   // been invalidated or while its scene requires update traversals
+   void SetRenderOnDemand(
+      const bool render_on_demand ) noexcept;
+   void Invalidate( ) noexcept;
+   bool NeedsRender( ) const noexcept;
+
+   // the swap chain grows within the depth when the consumer holds
+   // on to the presented frames and shrinks back once it is idle
+   void SetSwapChainDepth(
+      const size_t minimum_depth,
+      const size_t maximum_depth ) noexcept;
+   SwapChainStatistics GetSwapChainStatistics( ) const noexcept;
+
+   // the attachments a frame is drawn to but not presented from are
+   // invalidated before the frame is drawn and once it is resolved,
+   // so the driver neither loads nor writes back their contents
+   void SetInvalidateAttachments(
+      const bool multisample_color,
+      const bool depth_stencil ) noexcept;
+
+   // the view renders at a fraction of its size and the consumer
+   // scales the frames up when presenting them.  a fixed scale turns
+   // the adaptive scale off, which otherwise lowers the scale down to
+   // the minimum while the frames cost more than the budget.
+   void SetRenderScale(
+      const double render_scale ) noexcept;
+   void SetAdaptiveRenderScale(
+      const double minimum_scale,
+      const std::chrono::steady_clock::duration frame_budget ) noexcept;
+
+   // input and camera changes are posted to the render thread of the
+   // view as render tasks, so they do not allocate a qt event each
+   void MouseMove(
+      const QPoint & position,
+      const Qt::MouseButtons buttons ) noexcept;
+   void SetCameraLookAt(
+      const std::array< double, 3 > & eye,
+      const std::array< double, 3 > & center,
+      const std::array< double, 3 > & up ) noexcept;
+
 signals:
    void Present(
       const std::shared_ptr<
-         std::pair< GLuint, gl::FenceSync > >  & fence_sync );
-
-protected:
-   bool event(
-      QEvent * const event ) final;
+         std::pair< ColorBuffer, gl::FenceSync > >  & fence_sync );
 
 private slots:
    void OnResize(
@@ -86,11 +151,7 @@ private slots:
       const int32_t height ) noexcept;
    void OnPresentComplete(
       const std::shared_ptr<
-         std::pair< GLuint, gl::FenceSync > > & fence_sync ) noexcept;
-   void OnSetCameraLookAt(
-      const std::array< double, 3 > & eye,
-      const std::array< double, 3 > & center,
-      const std::array< double, 3 > & up ) noexcept;
+         std::pair< ColorBuffer, gl::FenceSync > > & fence_sync ) noexcept;
 
 private:
    void SetupOSG(
@@ -101,38 +162,119 @@ private:
    void ReleaseSignalsSlots( ) noexcept;
    osg::ref_ptr< osg::Texture >
    SetupDepthBuffer(
-      const Multisample multisample ) noexcept;
+      const Multisample multisample,
+      const uint32_t width,
+      const uint32_t height ) noexcept;
    osg::ref_ptr< osg::Texture2DMultisample >
    SetupStencilBuffer(
-      const Multisample multisample ) noexcept;
+      const Multisample multisample,
+      const uint32_t width,
+      const uint32_t height ) noexcept;
    osg::ref_ptr< osg::Texture2DMultisample >
    SetupMultisampleBuffer(
+      const Multisample multisample,
+      const uint32_t width,
+      const uint32_t height ) noexcept;
+   render_target_pool::Attachments
+   CreateMultisampleAttachments(
+      const uint32_t width,
+      const uint32_t height,
       const Multisample multisample ) noexcept;
+   osg::ref_ptr< osg::FrameBufferObject >
+   CreateMultisampleFrameBuffer(
+      const render_target_pool::Attachments & attachments ) noexcept;
+   void BorrowMultisampleTarget( ) noexcept;
+   void InvalidateFrameBuffer( ) noexcept;
+   // resolves the multisampled frame to the color buffer it presents
+   void ResolveFrame( ) noexcept;
+   void GovernFrameCost(
+      const std::chrono::steady_clock::duration frame_cost ) noexcept;
+   void UpdateRenderSize( ) noexcept;
 
+   void UpdateModel( ) noexcept;
+   void CompileModel( ) noexcept;
+   void AttachModel(
+      osg::Node & model ) noexcept;
    void UpdateText(
-      const GLuint color_buffer_texture_id ) const noexcept;
+      const ColorBuffer & color_buffer ) const noexcept;
    void UpdateTextProjection( ) const noexcept;
 
-   std::pair< bool, GLuint > SetupNextFrame( ) noexcept;
-   std::pair< GLuint, osg::ref_ptr< osg::FrameBufferObject > >
-   GetNextFrameBuffer( ) noexcept;
+   std::pair< bool, ColorBuffer > SetupNextFrame( ) noexcept;
+   gl::FenceSync InsertFence( ) noexcept;
+   void PresentFrame(
+      gl::FenceSync fence_sync ) noexcept;
+   void RecordGPUTime( ) noexcept;
+   std::pair< ColorBuffer, osg::ref_ptr< osg::FrameBufferObject > >
+   CreateColorFrameBuffer(
+      const osg::ref_ptr< osg::Texture > & depth_buffer ) noexcept;
 
    uint32_t width_;
    uint32_t height_;
+   // the size of the frames, the view size times the scale
+   uint32_t render_width_;
+   uint32_t render_height_;
+   // the size of the buffers, the frame size rounded up to a bucket
+   uint32_t target_width_;
+   uint32_t target_height_;
 
+   // the prepare and cull stages use the first scene view and the
+   // draw stage uses the second.  the two are swapped every frame.
    osg::ref_ptr< osgUtil::SceneView > osg_scene_view_;
+   osg::ref_ptr< osgUtil::SceneView > draw_scene_view_;
 
+   Multisample multisample_;
+   // the frame buffer of the view, with attachments of its own or
+   // borrowed from the render target pool
    osg::ref_ptr< osg::FrameBufferObject > multisample_frame_buffer_;
+   osg::ref_ptr< render_target_pool::Target > multisample_target_;
+   // lowers the level while the view misses its frame budget
+   MultisampleGovernor multisample_governor_;
+   RenderScaleGovernor render_scale_governor_;
+
+   // shared by the color buffers when not multisampling
+   osg::ref_ptr< osg::Texture > color_depth_buffer_;
 
-   std::map< GLuint, osg::ref_ptr< osg::FrameBufferObject > > active_frame_buffers_;
-   std::map< GLuint, osg::ref_ptr< osg::FrameBufferObject > > inactive_frame_buffers_;
+   std::unique_ptr< SwapChain > swap_chain_;
 
    std::vector<
       std::shared_ptr<
-         std::pair< GLuint, gl::FenceSync > > > completed_frames_;
+         std::pair< ColorBuffer, gl::FenceSync > > > completed_frames_;
+
+   std::shared_future< osg::ref_ptr< osg::Node > > pending_model_;
+
+   osg::ref_ptr< osgUtil::IncrementalCompileOperation > incremental_compile_;
+   osg::ref_ptr< osg::Group > compiled_model_;
+   // holds the model or the placeholder in the scene graph of the view
+   osg::ref_ptr< osg::Group > model_group_;
+   bool compiling_model_;
+   // the replaced model may still be drawn by a pending frame
+   osg::ref_ptr< osg::Node > retired_model_;
+
+   bool frame_prepared_;
+   ColorBuffer frame_color_buffer_;
+   // the frame buffer of the color buffer a multisampled frame is
+   // resolved to, which the view resolves instead of the render stage
+   osg::ref_ptr< osg::FrameBufferObject > frame_resolve_frame_buffer_;
+   Multisample frame_multisample_;
+   bool frame_pending_;
+   ColorBuffer draw_color_buffer_;
+   osg::ref_ptr< osg::FrameBufferObject > draw_resolve_frame_buffer_;
+   Multisample draw_multisample_;
+
+   // marks the start of the draw, the end of the geometry
+   // and the end of the multisample resolve.  the resolve
+   // of a frame that is not multisampled takes no time.
+   std::unique_ptr< gl::TimerQuery > draw_timer_;
+   std::vector< std::chrono::nanoseconds > draw_gpu_intervals_;
 
    QPoint previous_mouse_pos_;
 
+   std::atomic_bool invalidate_multisample_color_;
+   std::atomic_bool invalidate_depth_stencil_;
+
+   std::atomic_bool render_on_demand_;
+   std::atomic_bool dirty_;
+
    const QObject & parent_;
    const osg::ref_ptr< osg::GraphicsContext > graphics_context_;
 
@@ -1,33 +1,65 @@
 #include "qt-gl-view.h"
+#include "fence-watcher.h"
+#include "frame-telemetry.h"
 #include "gl-fence-sync.h"
 #include "multisample.h"
 #include "osg-view.h"
-#include "osg-view-mouse-event.h"
 #include "render-thread.h"
 
 #include <QtGui/QCloseEvent>
+#include <QtGui/QMouseEvent>
 #include <QtGui/QOpenGLContext>
 #include <QtGui/QOpenGLFunctions>
 #include <QtGui/QOpenGLShader>
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QEvent>
+#include <QtCore/QThread>
 
 #include <Qt>
 
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+
+// the default way the views wait for the frames they present
+#define USE_SERVER_WAIT_PRESENT 1
+#define USE_GPU_TIMER_QUERIES 1
+
+#ifndef GL_TEXTURE_2D_ARRAY
+#define GL_TEXTURE_2D_ARRAY               0x8C1A
+#endif
+
+static std::atomic_bool server_wait_present_ {
+   USE_SERVER_WAIT_PRESENT };
+
 void ReleaseOSGView(
    const OSGView * const osg_view ) noexcept
 {
    if (osg_view)
    {
-      render_thread::AddOperation(
+      const auto release =
          [ osg_view ] ( )
          {
             QCoreApplication::sendPostedEvents(
                const_cast< OSGView * >(osg_view));
 
             delete osg_view;
-         }).wait();
+         };
+
+      // the view must be released on the render thread that has
+      // affinity with the view.  a render thread executing an
+      // operation for the view may hold the last reference.
+      if (osg_view->thread() == QThread::currentThread())
+      {
+         release();
+      }
+      else
+      {
+         render_thread::AddOperation(
+            render_thread::RenderThreadOf(*osg_view),
+            release).wait();
+      }
    }
 }
 
@@ -35,13 +67,101 @@ QtGLView::QtGLView(
    std::string model,
    QWidget * const parent ) noexcept :
 QOpenGLWidget { parent },
+present_mode_ { PresentMode::MAILBOX },
+upscale_filter_ { UpscaleFilter::SHARPEN },
 render_scene_pgm_ { this },
 scene_data_vao_ { this },
+present_timer_ { 2 },
 osg_view_ { nullptr },
 model_ { std::move(model) }
 {
 }
 
+void QtGLView::SetPresentMode(
+   const PresentMode present_mode ) noexcept
+{
+   present_mode_ = present_mode;
+
+   if (present_mode_ == PresentMode::MAILBOX)
+   {
+      if (server_wait_present_)
+      {
+         ReleaseSupersededColorBuffers();
+      }
+      else
+      {
+         makeCurrent();
+         ReleaseSupersededColorBuffers();
+         doneCurrent();
+      }
+   }
+}
+
+void QtGLView::SetUpscaleFilter(
+   const UpscaleFilter upscale_filter ) noexcept
+{
+   upscale_filter_ = upscale_filter;
+
+   update();
+}
+
+void QtGLView::SetServerWaitPresent(
+   const bool server_wait_present ) noexcept
+{
+   server_wait_present_ = server_wait_present;
+}
+
+bool QtGLView::UsesFenceWatcher( ) noexcept
+{
+   return !server_wait_present_;
+}
+
+void QtGLView::SetCameraLookAt(
+   const std::array< double, 3 > & eye,
+   const std::array< double, 3 > & center,
+   const std::array< double, 3 > & up ) noexcept
+{
+   if (osg_view_)
+   {
+      // the render thread that renders the view when the task is
+      // executed keeps the view alive while the task executes, even
+      // when the view migrated after the task was posted
+      render_thread::PostOperation(
+#if _has_cxx_std_shared_ptr_weak_type
+         decltype(osg_view_)::weak_type { osg_view_ },
+#else
+         std::weak_ptr< OSGView > { osg_view_ },
+#endif
+         [ osg_view = osg_view_.get(), eye, center, up ] ( )
+         {
+            osg_view->SetCameraLookAt(
+               eye,
+               center,
+               up);
+         });
+   }
+}
+
+bool QtGLView::event(
+   QEvent * const event )
+{
+   bool handled { false };
+
+   if (event->type() == FRAME_READY_EVENT)
+   {
+      update();
+
+      handled = true;
+   }
+   else
+   {
+      handled =
+         QOpenGLWidget::event(event);
+   }
+
+   return handled;
+}
+
 void QtGLView::initializeGL( )
 {
    QOpenGLWidget::initializeGL();
@@ -118,14 +238,64 @@ void QtGLView::initializeGL( )
          "#version 330\n"
          ""
          "uniform sampler2D frame_sampler_2d;"
+         "uniform sampler2DArray frame_sampler_2d_array;"
+         "uniform int frame_layer;"
+         // the frame covers the lower left of a larger buffer
+         "uniform vec2 frame_size;"
+         // the view renders at a fraction of the widget size
+         "uniform vec2 present_size;"
+         "uniform int upscale_sharpen;"
+         ""
+         "const float sharpness = 0.5f;"
          ""
          "smooth in vec2 texture_coord;"
          ""
          "layout( location = 0 ) out vec4 frag_color_0;"
          ""
+         // the texture filters belong to the view, so the frame is
+         // filtered from fetched texels instead
+         "vec4 FetchTexel( ivec2 texel )"
+         "{"
+         "  texel = clamp(texel, ivec2(0), ivec2(frame_size) - 1);"
+         ""
+         "  return frame_layer < 0 ?"
+         "    texelFetch(frame_sampler_2d, texel, 0) :"
+         "    texelFetch(frame_sampler_2d_array, ivec3(texel, frame_layer), 0);"
+         "}"
+         ""
+         "vec4 SampleBilinear( vec2 position )"
+         "{"
+         "  position -= 0.5f;"
+         ""
+         "  ivec2 texel = ivec2(floor(position));"
+         "  vec2 weight = fract(position);"
+         ""
+         "  return"
+         "    mix("
+         "      mix(FetchTexel(texel), FetchTexel(texel + ivec2(1, 0)), weight.x),"
+         "      mix(FetchTexel(texel + ivec2(0, 1)), FetchTexel(texel + ivec2(1, 1)), weight.x),"
+         "      weight.y);"
+         "}"
+         ""
          "void main( void )"
          "{"
-         "  frag_color_0 = texture(frame_sampler_2d, texture_coord);"
+         "  vec2 position = texture_coord * frame_size;"
+         ""
+         "  vec4 color = SampleBilinear(position);"
+         ""
+         "  if (upscale_sharpen != 0 &&"
+         "      any(lessThan(frame_size, present_size)))"
+         "  {"
+         "    vec4 blur ="
+         "      (SampleBilinear(position + vec2(-1.0f, 0.0f)) +"
+         "       SampleBilinear(position + vec2(1.0f, 0.0f)) +"
+         "       SampleBilinear(position + vec2(0.0f, -1.0f)) +"
+         "       SampleBilinear(position + vec2(0.0f, 1.0f))) * 0.25f;"
+         ""
+         "    color = clamp(color + (color - blur) * sharpness, 0.0f, 1.0f);"
+         "  }"
+         ""
+         "  frag_color_0 = color;"
          "}");
 
       render_scene_pgm_.link();
@@ -133,6 +303,9 @@ void QtGLView::initializeGL( )
       render_scene_pgm_.setUniformValue(
          "frame_sampler_2d",
          0);
+      render_scene_pgm_.setUniformValue(
+         "frame_sampler_2d_array",
+         1);
 
       scene_data_vao_.create();
 
@@ -156,7 +329,40 @@ void QtGLView::paintGL( )
 {
    QOpenGLWidget::paintGL();
 
+   if (server_wait_present_)
    {
+      if (!waiting_color_buffers_.empty())
+      {
+         // the gpu waits on the fence of the frame before sampling
+         // it, so the frame is presented without waiting for it to
+         // complete
+         if (current_color_buffer_)
+         {
+            emit PresentComplete(
+               current_color_buffer_);
+         }
+
+         current_color_buffer_ =
+            waiting_color_buffers_.front();
+
+         waiting_color_buffers_.pop_front();
+
+         current_color_buffer_->second.WaitOnServer();
+
+         // fifo presents one frame per paint
+         if (!waiting_color_buffers_.empty())
+         {
+            update();
+         }
+      }
+   }
+   else
+   {
+      if (present_mode_ == PresentMode::MAILBOX)
+      {
+         ReleaseSupersededColorBuffers();
+      }
+
       auto color_buffer =
          waiting_color_buffers_.cbegin();
 
@@ -164,7 +370,12 @@ void QtGLView::paintGL( )
       {
          if (!(*color_buffer)->second.IsSignaled())
          {
-            update();
+            // the fence watcher requests the repaint once the
+            // frame is complete, otherwise the fence is polled
+            if (!fence_watcher::Running())
+            {
+               update();
+            }
 
             break;
          }
@@ -191,23 +402,62 @@ void QtGLView::paintGL( )
       render_scene_pgm_.bind();
       scene_data_vao_.bind();
 
+      const auto & color_buffer =
+         current_color_buffer_->first;
+
+      render_scene_pgm_.setUniformValue(
+         "frame_layer",
+         color_buffer.layer);
+      // only the part of the buffer the frame covers is sampled
+      render_scene_pgm_.setUniformValue(
+         "frame_size",
+         static_cast< GLfloat >(color_buffer.width),
+         static_cast< GLfloat >(color_buffer.height));
+      render_scene_pgm_.setUniformValue(
+         "present_size",
+         static_cast< GLfloat >(width() * devicePixelRatioF()),
+         static_cast< GLfloat >(height() * devicePixelRatioF()));
+      render_scene_pgm_.setUniformValue(
+         "upscale_sharpen",
+         upscale_filter_ == UpscaleFilter::SHARPEN ? 1 : 0);
+
+      // frames rendered to a layer of a texture array
+      // are sampled from the texture array unit
       const auto gl_functions =
          context()->functions();
       gl_functions->glActiveTexture(
-         GL_TEXTURE0);
+         color_buffer.layer < 0 ?
+         GL_TEXTURE0 :
+         GL_TEXTURE1);
 
       glBindTexture(
-         GL_TEXTURE_2D,
-         current_color_buffer_->first);
+         color_buffer.layer < 0 ?
+         GL_TEXTURE_2D :
+         GL_TEXTURE_2D_ARRAY,
+         color_buffer.texture_id);
+
+#if USE_GPU_TIMER_QUERIES
+      present_timer_.BeginFrame();
+      present_timer_.Mark();
+#endif
 
       glDrawArrays(
          GL_TRIANGLES,
          0,
          6);
 
+#if USE_GPU_TIMER_QUERIES
+      present_timer_.Mark();
+      present_timer_.EndFrame();
+#endif
+
       scene_data_vao_.release();
       render_scene_pgm_.release();
    }
+
+#if USE_GPU_TIMER_QUERIES
+   RecordGPUTime();
+#endif
 }
 
 void QtGLView::closeEvent(
@@ -215,6 +465,9 @@ void QtGLView::closeEvent(
 {
    ReleaseSignalsSlots();
 
+   fence_watcher::Unwatch(
+      *this);
+
    QCoreApplication::sendPostedEvents(
       this,
       QEvent::Type::MetaCall);
@@ -228,6 +481,7 @@ void QtGLView::closeEvent(
 
    makeCurrent();
    scene_data_vao_.destroy();
+   present_timer_.Release();
    doneCurrent();
 
    if (current_color_buffer_)
@@ -252,12 +506,20 @@ void QtGLView::mouseMoveEvent(
 {
    if (osg_view_)
    {
-      QCoreApplication::postEvent(
-         osg_view_.get(),
-         new MouseEvent {
-            static_cast< QEvent::Type >(MOUSE_MOVE_EVENT),
-            *event },
-         Qt::NormalEventPriority);
+      render_thread::PostOperation(
+#if _has_cxx_std_shared_ptr_weak_type
+         decltype(osg_view_)::weak_type { osg_view_ },
+#else
+         std::weak_ptr< OSGView > { osg_view_ },
+#endif
+         [ osg_view = osg_view_.get(),
+           position = event->pos(),
+           buttons = event->buttons() ] ( )
+         {
+            osg_view->MouseMove(
+               position,
+               buttons);
+         });
    }
 }
 
@@ -287,7 +549,7 @@ void QtGLView::ReleaseSignalsSlots( ) noexcept
 
 void QtGLView::OnPresent(
    const std::shared_ptr<
-      std::pair< GLuint, gl::FenceSync > > & fence_sync ) noexcept
+      std::pair< ColorBuffer, gl::FenceSync > > & fence_sync ) noexcept
 {
    if (fence_sync &&
        fence_sync->second.Valid())
@@ -295,6 +557,83 @@ void QtGLView::OnPresent(
       waiting_color_buffers_.emplace_back(
          fence_sync);
 
-      update();
+      if (server_wait_present_)
+      {
+         if (present_mode_ == PresentMode::MAILBOX)
+         {
+            ReleaseSupersededColorBuffers();
+         }
+
+         update();
+      }
+      else
+      {
+         if (present_mode_ == PresentMode::MAILBOX)
+         {
+            // the fences can only be queried with a current context
+            makeCurrent();
+            ReleaseSupersededColorBuffers();
+            doneCurrent();
+         }
+
+         if (fence_watcher::Running())
+         {
+            fence_watcher::Watch(
+               fence_sync,
+               *this);
+         }
+         else
+         {
+            update();
+         }
+      }
+   }
+}
+
+void QtGLView::RecordGPUTime( ) noexcept
+{
+   // the time is recorded against the view that rendered the frame
+   while (present_timer_.Intervals(present_gpu_intervals_))
+   {
+      telemetry::Record(
+         telemetry::Phase::VIEW_GPU_PRESENT,
+         present_gpu_intervals_[0],
+         osg_view_.get());
+   }
+}
+
+void QtGLView::ReleaseSupersededColorBuffers( ) noexcept
+{
+   // the newest frame can be presented whether it is complete or not
+   // when the gpu waits on its fence.  otherwise fences signal in the
+   // order the frames were rendered, so every frame before the newest
+   // signaled one can be returned right away.
+   const auto newest_signaled =
+      server_wait_present_ ?
+      waiting_color_buffers_.crbegin() :
+      std::find_if(
+         waiting_color_buffers_.crbegin(),
+         waiting_color_buffers_.crend(),
+         [ ] ( const auto & color_buffer )
+         {
+            return color_buffer->second.IsSignaled();
+         });
+
+   if (newest_signaled != waiting_color_buffers_.crend())
+   {
+      const auto superseded_end =
+         std::prev(newest_signaled.base());
+
+      for (auto color_buffer = waiting_color_buffers_.cbegin();
+           color_buffer != superseded_end;
+           ++color_buffer)
+      {
+         emit PresentComplete(
+            *color_buffer);
+      }
+
+      waiting_color_buffers_.erase(
+         waiting_color_buffers_.cbegin(),
+         superseded_end);
    }
 }
@@ -1,7 +1,9 @@
 #ifndef _QT_GL_VIEW_H_
 #define _QT_GL_VIEW_H_
 
+#include "color-buffer.h"
 #include "gl-fence-sync.h"
+#include "gl-timer-query.h"
 
 #include <QtWidgets/QOpenGLWidget>
 #include <QtWidgets/QWidget>
@@ -22,16 +24,37 @@
 #endif
 
 #include <array>
+#include <chrono>
 #include <cstdint>
 #include <list>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 class OSGView;
 class QCloseEvent;
+class QEvent;
 class QMouseEvent;
 
+enum class PresentMode
+{
+   // every frame is presented in the order it was rendered
+   FIFO,
+   // only the newest completed frame is kept for presentation
+   // and the frames it supersedes are returned to the view
+   MAILBOX
+};
+
+// the filter that scales up frames rendered below the widget size
+enum class UpscaleFilter
+{
+   BILINEAR,
+   // bilinear followed by an unsharp mask, which restores some of
+   // the edge contrast lost to the lower resolution
+   SHARPEN
+};
+
 class QtGLView final :
    public QOpenGLWidget
 {
@@ -42,19 +65,36 @@ public:
       std::string model,
       QWidget * const parent ) noexcept;
 
+   void SetPresentMode(
+      const PresentMode present_mode ) noexcept;
+   void SetUpscaleFilter(
+      const UpscaleFilter upscale_filter ) noexcept;
+
+   // the frames are presented right away with the gpu waiting on
+   // their fences, which is the default, or once the fence watcher
+   // reports them complete, so the fence watcher only has to run in
+   // the latter case.  selected for all views before any is shown.
+   static void SetServerWaitPresent(
+      const bool server_wait_present ) noexcept;
+   static bool UsesFenceWatcher( ) noexcept;
+
+   void SetCameraLookAt(
+      const std::array< double, 3 > & eye,
+      const std::array< double, 3 > & center,
+      const std::array< double, 3 > & up ) noexcept;
+
 signals:
    void Resize(
       const int32_t width,
       const int32_t height );
    void PresentComplete(
       const std::shared_ptr<
-         std::pair< GLuint, gl::FenceSync > > & fence_sync );
-   void SetCameraLookAt(
-      const std::array< double, 3 > & eye,
-      const std::array< double, 3 > & center,
-      const std::array< double, 3 > & up );
+         std::pair< ColorBuffer, gl::FenceSync > > & fence_sync );
 
 protected:
+   bool event(
+      QEvent * const event ) final;
+
    void initializeGL( ) final;
    void resizeGL(
       const int32_t width,
@@ -69,21 +109,31 @@ protected:
 private slots:
    void OnPresent(
       const std::shared_ptr<
-         std::pair< GLuint, gl::FenceSync > > & fence_sync ) noexcept;
+         std::pair< ColorBuffer, gl::FenceSync > > & fence_sync ) noexcept;
 
 private:
    void SetupSignalsSlots( ) noexcept;
    void ReleaseSignalsSlots( ) noexcept;
 
-   std::shared_ptr< std::pair< GLuint, gl::FenceSync > >
+   void ReleaseSupersededColorBuffers( ) noexcept;
+   void RecordGPUTime( ) noexcept;
+
+   PresentMode present_mode_;
+   UpscaleFilter upscale_filter_;
+
+   std::shared_ptr< std::pair< ColorBuffer, gl::FenceSync > >
       current_color_buffer_;
    std::list<
-      std::shared_ptr< std::pair< GLuint, gl::FenceSync > > >
+      std::shared_ptr< std::pair< ColorBuffer, gl::FenceSync > > >
       waiting_color_buffers_;
 
    QOpenGLShaderProgram render_scene_pgm_;
    QOpenGLVertexArrayObject scene_data_vao_;
 
+   // marks the start and the end of drawing the frame to the widget
+   gl::TimerQuery present_timer_;
+   std::vector< std::chrono::nanoseconds > present_gpu_intervals_;
+
    std::shared_ptr< OSGView > osg_view_;
 
    const std::string model_;
@@ -0,0 +1,169 @@
+#include "render-scale-governor.h"
+
+#include <algorithm>
+#include <cmath>
+
+// frames averaged before the scale is reconsidered
+static const uint32_t WINDOW_FRAMES { 15 };
+// windows in a row that must allow a higher scale before rising
+static const uint32_t STEP_UP_WINDOWS { 4 };
+// the scale aims below the budget to leave room for noise
+static const double BUDGET_TARGET { 0.9 };
+// scales are multiples of the step
+static const double SCALE_STEP { 1.0 / 16.0 };
+
+RenderScaleGovernor::RenderScaleGovernor(
+   const uint32_t settle_frames ) noexcept :
+settle_frames_ { settle_frames },
+frame_budget_ { Clock::duration::zero() },
+minimum_scale_ { 1.0 },
+maximum_scale_ { 1.0 },
+scale_ { 1.0 },
+step_up_scale_ { 1.0 },
+unsettled_frames_ { 0 },
+window_frames_ { 0 },
+window_cost_ { Clock::duration::zero() },
+window_frame_cost_ { Clock::duration::zero() },
+step_up_windows_ { 0 }
+{
+}
+
+void RenderScaleGovernor::SetFrameBudget(
+   const Clock::duration frame_budget ) noexcept
+{
+   frame_budget_ = frame_budget;
+}
+
+RenderScaleGovernor::Clock::duration
+RenderScaleGovernor::FrameBudget( ) const noexcept
+{
+   return frame_budget_;
+}
+
+void RenderScaleGovernor::SetScaleRange(
+   const double minimum_scale,
+   const double maximum_scale ) noexcept
+{
+   maximum_scale_ =
+      std::min(std::max(maximum_scale, SCALE_STEP), 1.0);
+   minimum_scale_ =
+      std::min(std::max(minimum_scale, SCALE_STEP), maximum_scale_.load());
+}
+
+bool RenderScaleGovernor::AddFrameCost(
+   const Clock::duration frame_cost ) noexcept
+{
+   const auto frame_budget =
+      frame_budget_.load();
+
+   if (frame_budget == Clock::duration::zero() ||
+       frame_cost <= Clock::duration::zero())
+   {
+      return false;
+   }
+
+   if (unsettled_frames_)
+   {
+      --unsettled_frames_;
+
+      return false;
+   }
+
+   window_cost_ += frame_cost;
+
+   if (++window_frames_ < WINDOW_FRAMES)
+   {
+      return false;
+   }
+
+   window_frame_cost_ =
+      window_cost_ / window_frames_;
+
+   window_frames_ = 0;
+   window_cost_ = Clock::duration::zero();
+
+   const auto scale =
+      Scale();
+
+   const auto budget_scale =
+      scale *
+      std::sqrt(
+         BUDGET_TARGET *
+         std::chrono::duration< double > { frame_budget }.count() /
+         std::chrono::duration< double > { window_frame_cost_ }.count());
+
+   // rounding down keeps the estimate within the budget
+   const auto next_scale =
+      std::min(
+         std::max(
+            std::floor(budget_scale / SCALE_STEP) * SCALE_STEP,
+            minimum_scale_.load()),
+         maximum_scale_.load());
+
+   bool changed { false };
+
+   if (next_scale < scale)
+   {
+      step_up_windows_ = 0;
+
+      scale_ = next_scale;
+      changed = true;
+   }
+   else if (next_scale > scale)
+   {
+      step_up_scale_ =
+         step_up_windows_ ?
+         std::min(step_up_scale_, next_scale) :
+         next_scale;
+
+      if (++step_up_windows_ >= STEP_UP_WINDOWS)
+      {
+         step_up_windows_ = 0;
+
+         scale_ = step_up_scale_;
+         changed = true;
+      }
+   }
+   else
+   {
+      step_up_windows_ = 0;
+   }
+
+   if (changed)
+   {
+      unsettled_frames_ = settle_frames_;
+   }
+
+   return changed;
+}
+
+double RenderScaleGovernor::Scale( ) const noexcept
+{
+   return
+      std::min(
+         std::max(
+            scale_,
+            minimum_scale_.load()),
+         maximum_scale_.load());
+}
+
+bool RenderScaleGovernor::AtMinimumScale( ) const noexcept
+{
+   return Scale() <= minimum_scale_;
+}
+
+bool RenderScaleGovernor::AtMaximumScale( ) const noexcept
+{
+   return Scale() >= maximum_scale_;
+}
+
+RenderScaleGovernor::Clock::duration
+RenderScaleGovernor::WindowFrameCost( ) const noexcept
+{
+   return window_frame_cost_;
+}
+
+uint32_t RenderScaleGovernor::WindowFrames( ) const noexcept
+{
+   return WINDOW_FRAMES;
+}
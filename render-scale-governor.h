@@ -0,0 +1,67 @@
+#ifndef _RENDER_SCALE_GOVERNOR_H_
+#define _RENDER_SCALE_GOVERNOR_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// picks the fraction of the view size a view renders at from its
+// measured frame cost.  the cost of a frame grows with the number
+// of pixels, so the scale that meets the budget is estimated from
+// the square root of the ratio of the budget to the cost.  scales
+// are quantized, so the color buffers are not reallocated for
+// every small change.  the scale drops as soon as a window misses
+// the budget and only rises after several windows in a row agree.
+class RenderScaleGovernor final
+{
+public:
+   using Clock = std::chrono::steady_clock;
+
+   // the costs of the settle frames following a change are ignored,
+   // as those frames may have been drawn before the change
+   explicit RenderScaleGovernor(
+      const uint32_t settle_frames ) noexcept;
+
+   // a budget of zero keeps the current scale
+   void SetFrameBudget(
+      const Clock::duration frame_budget ) noexcept;
+   Clock::duration FrameBudget( ) const noexcept;
+
+   // a range with equal ends fixes the scale
+   void SetScaleRange(
+      const double minimum_scale,
+      const double maximum_scale ) noexcept;
+
+   // returns if the frame cost changed the scale
+   bool AddFrameCost(
+      const Clock::duration frame_cost ) noexcept;
+
+   // the scale within the current range
+   double Scale( ) const noexcept;
+   bool AtMinimumScale( ) const noexcept;
+   bool AtMaximumScale( ) const noexcept;
+
+   // the average frame cost of the last complete window
+   Clock::duration WindowFrameCost( ) const noexcept;
+   uint32_t WindowFrames( ) const noexcept;
+
+private:
+   const uint32_t settle_frames_;
+
+   std::atomic< Clock::duration > frame_budget_;
+   std::atomic< double > minimum_scale_;
+   std::atomic< double > maximum_scale_;
+
+   double scale_;
+   // the lowest scale the windows since the last change allowed
+   double step_up_scale_;
+
+   uint32_t unsettled_frames_;
+   uint32_t window_frames_;
+   Clock::duration window_cost_;
+   Clock::duration window_frame_cost_;
+   uint32_t step_up_windows_;
+
+};
+
+#endif // _RENDER_SCALE_GOVERNOR_H_
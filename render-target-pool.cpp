@@ -0,0 +1,257 @@
+#include "render-target-pool.h"
+#include "frame-telemetry.h"
+
+#include <osg/Texture>
+
+#include <map>
+#include <mutex>
+#include <utility>
+#include <tuple>
+
+namespace render_target_pool
+{
+
+// context id, width, height and sample count
+using Key =
+   std::tuple< uint32_t, uint32_t, uint32_t, uint32_t >;
+
+static std::map< Key, osg::ref_ptr< Target > > targets_;
+static std::mutex targets_mutex_;
+
+static Statistics CollectStatistics( )
+{
+   Statistics statistics;
+
+   for (const auto & target : targets_)
+   {
+      // the pool holds one of the references
+      const auto borrowers =
+         static_cast< size_t >(
+            target.second->referenceCount() - 1);
+
+      statistics.targets += 1;
+      statistics.borrowers += borrowers;
+      statistics.allocated_bytes += target.second->Bytes();
+
+      if (borrowers > 1)
+      {
+         statistics.saved_bytes +=
+            (borrowers - 1) * target.second->Bytes();
+      }
+   }
+
+   return statistics;
+}
+
+static uint64_t AllocatedBytes( )
+{
+   uint64_t allocated_bytes { 0 };
+
+   for (const auto & target : targets_)
+   {
+      allocated_bytes += target.second->Bytes();
+   }
+
+   return allocated_bytes;
+}
+
+// a target the pool holds the only reference to is no longer borrowed
+static void FreeUnborrowedTargets( )
+{
+   for (auto target = targets_.begin(); target != targets_.end(); )
+   {
+      if (target->second->referenceCount() == 1)
+      {
+         const auto bytes =
+            target->second->Bytes();
+
+         target =
+            targets_.erase(
+               target);
+
+         telemetry::RecordEvent(
+            telemetry::Event::RENDER_TARGET_FREED,
+            static_cast< double >(bytes),
+            static_cast< double >(AllocatedBytes()));
+      }
+      else
+      {
+         ++target;
+      }
+   }
+}
+
+Target::Target(
+   Attachments attachments,
+   const uint32_t width,
+   const uint32_t height,
+   const uint32_t samples,
+   const uint64_t bytes ) noexcept :
+attachments_ { std::move(attachments) },
+width_ { width },
+height_ { height },
+samples_ { samples },
+bytes_ { bytes }
+{
+}
+
+Target::~Target( ) noexcept
+{
+}
+
+const Attachments & Target::GetAttachments( ) const noexcept
+{
+   return attachments_;
+}
+
+uint32_t Target::Width( ) const noexcept
+{
+   return width_;
+}
+
+uint32_t Target::Height( ) const noexcept
+{
+   return height_;
+}
+
+uint32_t Target::Samples( ) const noexcept
+{
+   return samples_;
+}
+
+uint64_t Target::Bytes( ) const noexcept
+{
+   return bytes_;
+}
+
+void Target::WaitForPreviousDraw( ) const noexcept
+{
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      drawn_mutex_ };
+#else
+   std::lock_guard< decltype(drawn_mutex_) > lock {
+      drawn_mutex_ };
+#endif
+
+   drawn_.WaitOnServer();
+}
+
+void Target::FenceDraw( ) noexcept
+{
+   gl::FenceSync drawn;
+
+   {
+#if _has_cxx_class_template_argument_deduction
+      std::lock_guard lock {
+         drawn_mutex_ };
+#else
+      std::lock_guard< decltype(drawn_mutex_) > lock {
+         drawn_mutex_ };
+#endif
+
+      std::swap(
+         drawn_,
+         drawn);
+   }
+
+   // the fence of the previous draw is deleted outside the lock
+}
+
+osg::ref_ptr< Target > Borrow(
+   const uint32_t context_id,
+   const uint32_t width,
+   const uint32_t height,
+   const uint32_t samples,
+   const uint32_t bytes_per_sample,
+   const CreateAttachments & create_attachments ) noexcept
+{
+   const Key key {
+      context_id,
+      width,
+      height,
+      samples };
+
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      targets_mutex_ };
+#else
+   std::lock_guard< decltype(targets_mutex_) > lock {
+      targets_mutex_ };
+#endif
+
+   auto target =
+      targets_.find(
+         key);
+
+   if (target == targets_.end())
+   {
+      auto attachments =
+         create_attachments(
+            width,
+            height,
+            samples);
+
+      if (!attachments.empty())
+      {
+         const auto bytes =
+            static_cast< uint64_t >(width) * height *
+            samples * bytes_per_sample;
+
+         target =
+            targets_.emplace(
+               key,
+               new Target {
+                  std::move(attachments),
+                  width,
+                  height,
+                  samples,
+                  bytes }).first;
+
+         telemetry::RecordEvent(
+            telemetry::Event::RENDER_TARGET_CREATED,
+            static_cast< double >(bytes),
+            static_cast< double >(AllocatedBytes()));
+      }
+   }
+
+   return
+      target != targets_.end() ?
+      target->second :
+      osg::ref_ptr< Target > { };
+}
+
+void Return(
+   osg::ref_ptr< Target > & target ) noexcept
+{
+   if (target)
+   {
+#if _has_cxx_class_template_argument_deduction
+      std::lock_guard lock {
+         targets_mutex_ };
+#else
+      std::lock_guard< decltype(targets_mutex_) > lock {
+         targets_mutex_ };
+#endif
+
+      target = nullptr;
+
+      FreeUnborrowedTargets();
+   }
+}
+
+Statistics GetStatistics( ) noexcept
+{
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      targets_mutex_ };
+#else
+   std::lock_guard< decltype(targets_mutex_) > lock {
+      targets_mutex_ };
+#endif
+
+   return
+      CollectStatistics();
+}
+
+} // namespace render_target_pool
@@ -0,0 +1,116 @@
+#ifndef _RENDER_TARGET_POOL_H_
+#define _RENDER_TARGET_POOL_H_
+
+#include "gl-fence-sync.h"
+
+#include <osg/FrameBufferObject>
+#include <osg/Referenced>
+#include <osg/ref_ptr>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace osg
+{
+class Texture;
+}
+
+namespace render_target_pool
+{
+
+using Attachments =
+   std::vector<
+      std::pair<
+         osg::FrameBufferObject::BufferComponent,
+         osg::ref_ptr< osg::Texture > > >;
+
+using CreateAttachments =
+   std::function<
+      Attachments (
+         const uint32_t width,
+         const uint32_t height,
+         const uint32_t samples ) >;
+
+// the multisample attachments whose contents are only needed while a
+// frame is drawn, up to its resolve.  frame buffer objects are not
+// shared between contexts, so every view attaches the textures to a
+// frame buffer of its own.
+class Target final :
+   public osg::Referenced
+{
+public:
+   Target(
+      Attachments attachments,
+      const uint32_t width,
+      const uint32_t height,
+      const uint32_t samples,
+      const uint64_t bytes ) noexcept;
+
+   const Attachments & GetAttachments( ) const noexcept;
+   uint32_t Width( ) const noexcept;
+   uint32_t Height( ) const noexcept;
+   uint32_t Samples( ) const noexcept;
+   uint64_t Bytes( ) const noexcept;
+
+   // the views sharing a target draw in contexts of their own, which
+   // gl does not order, so a view waits on the gpu for the draw to
+   // the target before its own and fences its draw once resolved.
+   // views on other render threads may wait while a view fences, so
+   // the fence is guarded by the target.  must be called with the
+   // context current.
+   void WaitForPreviousDraw( ) const noexcept;
+   void FenceDraw( ) noexcept;
+
+protected:
+   ~Target( ) noexcept override;
+
+private:
+   const Attachments attachments_;
+   const uint32_t width_;
+   const uint32_t height_;
+   const uint32_t samples_;
+   const uint64_t bytes_;
+
+   gl::FenceSync drawn_;
+   mutable std::mutex drawn_mutex_;
+
+};
+
+// returns the target for the context id, size and sample count,
+// creating it when no view holds one.  the textures are created for
+// the context id, so only views sharing a context id share a target.
+// must be called with the context current and its gl objects locked.
+osg::ref_ptr< Target > Borrow(
+   const uint32_t context_id,
+   const uint32_t width,
+   const uint32_t height,
+   const uint32_t samples,
+   const uint32_t bytes_per_sample,
+   const CreateAttachments & create_attachments ) noexcept;
+// lets go of the target and frees it once no view holds it.  must be
+// called with the context current and its gl objects locked, as the
+// fence of the target is deleted along with it.
+void Return(
+   osg::ref_ptr< Target > & target ) noexcept;
+
+struct Statistics
+{
+   size_t targets { 0 };
+   // views holding one of the targets
+   size_t borrowers { 0 };
+
+   uint64_t allocated_bytes { 0 };
+   // what the views would have allocated each on their own,
+   // less what the shared targets allocate
+   uint64_t saved_bytes { 0 };
+};
+
+Statistics GetStatistics( ) noexcept;
+
+} // namespace render_target_pool
+
+#endif // _RENDER_TARGET_POOL_H_
@@ -0,0 +1,366 @@
+#ifndef _RENDER_TASK_H_
+#define _RENDER_TASK_H_
+
+#include "block-pool.h"
+
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// move only callable with small buffer storage.  callables that
+// fit in the buffer and are nothrow move constructible are stored
+// in place, all others fall back to the heap.
+class RenderTask final
+{
+public:
+   RenderTask( ) noexcept;
+   template <
+      typename Callable,
+      typename = std::enable_if_t<
+         !std::is_same< std::decay_t< Callable >, RenderTask >::value >,
+      typename = decltype(
+         std::declval< std::decay_t< Callable > & >()()) >
+   RenderTask(
+      Callable && callable ) noexcept;
+   ~RenderTask( ) noexcept;
+
+   RenderTask( RenderTask && o ) noexcept;
+   RenderTask( const RenderTask & ) noexcept = delete;
+
+   RenderTask & operator = ( RenderTask && o ) noexcept;
+   RenderTask & operator = ( const RenderTask & ) noexcept = delete;
+
+   bool Valid( ) const noexcept;
+
+   void operator ( ) ( ) noexcept;
+
+private:
+   // large enough for a camera look at and a few pointers
+   static constexpr size_t STORAGE_SIZE { 96 };
+
+   using Storage =
+      std::aligned_storage_t<
+         STORAGE_SIZE,
+         alignof(std::max_align_t) >;
+
+   struct Operations
+   {
+      void (*invoke)( void * const callable );
+      void (*move)( void * const to, void * const from );
+      void (*destroy)( void * const callable );
+   };
+
+   template < typename Callable >
+   struct LocalOperations;
+   template < typename Callable >
+   struct HeapOperations;
+
+   template < typename Callable >
+   using IsLocal =
+      std::integral_constant<
+         bool,
+         sizeof(Callable) <= STORAGE_SIZE &&
+         alignof(Callable) <= alignof(Storage) &&
+         std::is_nothrow_move_constructible< Callable >::value >;
+
+   template < typename Callable >
+   void Construct(
+      Callable && callable,
+      std::true_type ) noexcept;
+   template < typename Callable >
+   void Construct(
+      Callable && callable,
+      std::false_type ) noexcept;
+
+   void Reset( ) noexcept;
+
+   const Operations * operations_;
+   Storage storage_;
+
+};
+
+template < typename Callable >
+struct RenderTask::LocalOperations
+{
+   static void Invoke(
+      void * const callable )
+   {
+      (*static_cast< Callable * >(callable))();
+   }
+
+   static void Move(
+      void * const to,
+      void * const from )
+   {
+      new (to) Callable {
+         std::move(*static_cast< Callable * >(from)) };
+
+      static_cast< Callable * >(from)->~Callable();
+   }
+
+   static void Destroy(
+      void * const callable )
+   {
+      static_cast< Callable * >(callable)->~Callable();
+   }
+
+   static constexpr Operations operations {
+      &Invoke, &Move, &Destroy };
+};
+
+template < typename Callable >
+constexpr RenderTask::Operations
+   RenderTask::LocalOperations< Callable >::operations;
+
+template < typename Callable >
+struct RenderTask::HeapOperations
+{
+   static void Invoke(
+      void * const callable )
+   {
+      (**static_cast< Callable ** >(callable))();
+   }
+
+   static void Move(
+      void * const to,
+      void * const from )
+   {
+      *static_cast< Callable ** >(to) =
+         *static_cast< Callable ** >(from);
+   }
+
+   static void Destroy(
+      void * const callable )
+   {
+      delete *static_cast< Callable ** >(callable);
+   }
+
+   static constexpr Operations operations {
+      &Invoke, &Move, &Destroy };
+};
+
+template < typename Callable >
+constexpr RenderTask::Operations
+   RenderTask::HeapOperations< Callable >::operations;
+
+inline RenderTask::RenderTask( ) noexcept :
+operations_ { nullptr }
+{
+}
+
+template < typename Callable, typename, typename >
+inline RenderTask::RenderTask(
+   Callable && callable ) noexcept :
+operations_ { nullptr }
+{
+   Construct(
+      std::forward< Callable >(callable),
+      IsLocal< std::decay_t< Callable > > { });
+}
+
+template < typename Callable >
+inline void RenderTask::Construct(
+   Callable && callable,
+   std::true_type ) noexcept
+{
+   using type = std::decay_t< Callable >;
+
+   new (&storage_) type {
+      std::forward< Callable >(callable) };
+
+   operations_ =
+      &LocalOperations< type >::operations;
+}
+
+template < typename Callable >
+inline void RenderTask::Construct(
+   Callable && callable,
+   std::false_type ) noexcept
+{
+   using type = std::decay_t< Callable >;
+
+   new (&storage_) type * {
+      new type { std::forward< Callable >(callable) } };
+
+   operations_ =
+      &HeapOperations< type >::operations;
+}
+
+inline RenderTask::~RenderTask( ) noexcept
+{
+   Reset();
+}
+
+inline RenderTask::RenderTask(
+   RenderTask && o ) noexcept :
+operations_ { o.operations_ }
+{
+   if (operations_)
+   {
+      operations_->move(
+         &storage_,
+         &o.storage_);
+
+      o.operations_ = nullptr;
+   }
+}
+
+inline RenderTask & RenderTask::operator = (
+   RenderTask && o ) noexcept
+{
+   if (&o != this)
+   {
+      Reset();
+
+      if (o.operations_)
+      {
+         o.operations_->move(
+            &storage_,
+            &o.storage_);
+
+         operations_ = o.operations_;
+         o.operations_ = nullptr;
+      }
+   }
+
+   return *this;
+}
+
+inline bool RenderTask::Valid( ) const noexcept
+{
+   return operations_;
+}
+
+inline void RenderTask::operator ( ) ( ) noexcept
+{
+   if (operations_)
+   {
+      operations_->invoke(
+         &storage_);
+   }
+}
+
+inline void RenderTask::Reset( ) noexcept
+{
+   if (operations_)
+   {
+      operations_->destroy(
+         &storage_);
+
+      operations_ = nullptr;
+   }
+}
+
+// signals the future handed out when the task was added.  both
+// the promise and its shared state come from the block pools.
+class RenderTaskCompletion final
+{
+public:
+   RenderTaskCompletion( ) noexcept;
+   ~RenderTaskCompletion( ) noexcept;
+
+   RenderTaskCompletion( RenderTaskCompletion && o ) noexcept;
+   RenderTaskCompletion( const RenderTaskCompletion & ) noexcept = delete;
+
+   RenderTaskCompletion & operator = ( RenderTaskCompletion && o ) noexcept;
+   RenderTaskCompletion & operator = ( const RenderTaskCompletion & ) noexcept = delete;
+
+   static RenderTaskCompletion Create(
+      std::future< void > & completed ) noexcept;
+
+   bool Valid( ) const noexcept;
+
+   void Complete( ) noexcept;
+
+private:
+   using Pool =
+      BlockPool<
+         sizeof(std::promise< void >),
+         alignof(std::promise< void >) >;
+
+   void Reset( ) noexcept;
+
+   std::promise< void > * complete_;
+
+};
+
+inline RenderTaskCompletion::RenderTaskCompletion( ) noexcept :
+complete_ { nullptr }
+{
+}
+
+inline RenderTaskCompletion::~RenderTaskCompletion( ) noexcept
+{
+   Reset();
+}
+
+inline RenderTaskCompletion::RenderTaskCompletion(
+   RenderTaskCompletion && o ) noexcept :
+complete_ { o.complete_ }
+{
+   o.complete_ = nullptr;
+}
+
+inline RenderTaskCompletion & RenderTaskCompletion::operator = (
+   RenderTaskCompletion && o ) noexcept
+{
+   if (&o != this)
+   {
+      Reset();
+
+      std::swap(
+         complete_,
+         o.complete_);
+   }
+
+   return *this;
+}
+
+inline RenderTaskCompletion RenderTaskCompletion::Create(
+   std::future< void > & completed ) noexcept
+{
+   RenderTaskCompletion completion;
+
+   completion.complete_ =
+      new (Pool::Allocate()) std::promise< void > {
+         std::allocator_arg,
+         BlockPoolAllocator< char > { } };
+
+   completed =
+      completion.complete_->get_future();
+
+   return completion;
+}
+
+inline bool RenderTaskCompletion::Valid( ) const noexcept
+{
+   return complete_;
+}
+
+inline void RenderTaskCompletion::Complete( ) noexcept
+{
+   if (complete_)
+   {
+      complete_->set_value();
+
+      Reset();
+   }
+}
+
+inline void RenderTaskCompletion::Reset( ) noexcept
+{
+   if (complete_)
+   {
+      complete_->~promise();
+
+      Pool::Release(
+         complete_);
+
+      complete_ = nullptr;
+   }
+}
+
+#endif // _RENDER_TASK_H_
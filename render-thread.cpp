@@ -1,125 +1,647 @@
 #include "render-thread.h"
+#include "frame-pacer.h"
+#include "frame-telemetry.h"
+#include "mpsc-queue.h"
 #include "osg-view.h"
+#include "worker-pool.h"
 
 #include <QtCore/QEventLoop>
+#include <QtCore/QObject>
+#include <QtCore/QThread>
 
 #include <algorithm>
 #include <atomic>
 #include <chrono>
-#include <deque>
-#include <iostream>
 #include <list>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <thread>
 #include <utility>
+#include <vector>
 
 extern void InitHiddenGLContext(
-   const std::any & hidden_context ) noexcept;
+   const std::any & hidden_context,
+   const bool share_context_id ) noexcept;
 extern void ReleaseHiddenGLContext( ) noexcept;
+extern void InitRenderThreadGLContext( ) noexcept;
+extern void ReleaseRenderThreadGLContext( ) noexcept;
+extern void MakeRenderThreadGLContextCurrent( ) noexcept;
+extern void ReleaseRenderThreadGLContextCurrent( ) noexcept;
 
 namespace render_thread
 {
 
-std::thread render_thread_;
+struct Operation
+{
+   RenderTask task;
+   RenderTaskCompletion completion;
+   std::chrono::steady_clock::time_point added;
+
+   // an operation for a view runs on the render thread that renders
+   // the view when the operation is executed, not the one it was
+   // pushed to, as the view may have migrated in between
+   std::weak_ptr< OSGView > osg_view;
+   bool view_operation { false };
+};
+
+struct RenderThread
+{
+   std::thread thread;
+   std::atomic< QThread * > qthread { nullptr };
+
+   std::atomic_bool quit { false };
+
+   MPSCQueue< Operation > operations;
+   // the thread stops accepting operations before its final drain
+   // and waits for the pushes in progress, so every operation is
+   // either executed or rejected to the thread that pushed it
+   std::atomic_bool accepting { true };
+   std::atomic< size_t > pushing { 0 };
+
+   std::atomic< uint64_t > operations_executed { 0 };
+   std::atomic< uint64_t > operations_total_wait_us { 0 };
+   std::atomic< uint64_t > operations_max_wait_us { 0 };
+
+   std::atomic< uint64_t > frames { 0 };
+   std::atomic< uint64_t > missed_deadlines { 0 };
+
+   std::list<
+      std::weak_ptr< OSGView > > osg_views;
+   std::mutex osg_views_mutex;
+
+   // views culled and drawn in the current frame
+   std::vector<
+      std::shared_ptr< OSGView > > frame_osg_views;
+   std::vector<
+      std::shared_ptr< OSGView > > draw_osg_views;
+};
+
+// start publishes the render threads once all of them own a context
+// and stop takes them back before stopping them, both while holding
+// the lock exclusively.  everything else reads them under a shared
+// lock, so the threads never change while they are looked up.
+std::vector<
+   std::unique_ptr< RenderThread > > render_threads_;
+std::shared_mutex render_threads_mutex_;
+// serializes starting and stopping the render threads
 std::mutex render_thread_mutex_;
 
-std::atomic_bool quit_render_thread_ { false };
+std::atomic< int64_t > operation_time_budget_us_ { 8000 };
 
-std::deque<
-   std::function< void ( ) > > operations_;
-std::mutex operations_mutex_;
+std::atomic< double > target_frame_rate_ { 30.0 };
+std::atomic_bool render_late_ { false };
 
-std::list<
-   std::weak_ptr< OSGView > > osg_views_;
-std::mutex osg_views_mutex_;
+std::atomic_bool parallel_cull_ { true };
+std::atomic_bool pipelined_render_ { true };
 
-size_t ExecuteOperation( )
+bool IsSameOSGView(
+   const std::weak_ptr< OSGView > & lhs,
+   const std::shared_ptr< OSGView > & rhs )
 {
-#if _has_cxx_class_template_argument_deduction
-   std::lock_guard lock {
-      operations_mutex_ };
-#else
-   std::lock_guard< decltype(operations_mutex_) > lock {
-      operations_mutex_ };
-#endif
+   const auto shared_lhs =
+      lhs.lock();
+
+   return
+      shared_lhs &&
+      rhs &&
+      shared_lhs == rhs;
+}
+
+std::shared_lock< std::shared_mutex > LockRenderThreads( );
+size_t FindOSGView(
+   const std::shared_ptr< OSGView > & osg_view );
 
-   if (!operations_.empty())
+bool PushOperation(
+   RenderThread & render_thread,
+   Operation operation )
+{
+   render_thread.pushing.fetch_add(
+      1);
+
+   const bool accepted {
+      render_thread.accepting.load() };
+
+   if (accepted)
    {
-      operations_.front()();
+      render_thread.operations.Push(
+         std::move(operation));
+   }
+
+   render_thread.pushing.fetch_sub(
+      1);
 
-      operations_.pop_front();
+   if (!accepted)
+   {
+      // a rejected operation is never executed
+      operation.completion.Complete();
    }
 
-   return operations_.size();
+   return accepted;
 }
 
-void RenderOSGViews( )
+bool RendersOSGView(
+   RenderThread & render_thread,
+   const std::shared_ptr< OSGView > & osg_view )
 {
 #if _has_cxx_class_template_argument_deduction
    std::lock_guard lock {
-      osg_views_mutex_ };
+      render_thread.osg_views_mutex };
 #else
-   std::lock_guard< decltype(osg_views_mutex_) > lock {
-      osg_views_mutex_ };
+   std::lock_guard< decltype(render_thread.osg_views_mutex) > lock {
+      render_thread.osg_views_mutex };
 #endif
 
-   for (const auto & osg_view : osg_views_)
+   return
+      std::any_of(
+         render_thread.osg_views.cbegin(),
+         render_thread.osg_views.cend(),
+         [ & osg_view ] ( const auto & view )
+         {
+            return IsSameOSGView(view, osg_view);
+         });
+}
+
+// hands an operation for a view that migrated off this render
+// thread to the render thread that renders the view now
+void ForwardOperation(
+   const std::shared_ptr< OSGView > & osg_view,
+   Operation operation )
+{
+   const auto lock =
+      LockRenderThreads();
+
+   const auto render_thread =
+      FindOSGView(osg_view);
+
+   if (render_thread < render_threads_.size())
+   {
+      PushOperation(
+         *render_threads_[render_thread],
+         std::move(operation));
+   }
+   else
+   {
+      // the view is no longer rendered or the render threads
+      // are stopping, so there is no thread to execute it on
+      operation.completion.Complete();
+   }
+}
+
+void ExecuteOperation(
+   RenderThread & render_thread,
+   Operation & operation )
+{
+   // the view is kept alive while its operation executes
+   std::shared_ptr< OSGView > osg_view;
+
+   if (operation.view_operation)
+   {
+      osg_view =
+         operation.osg_view.lock();
+
+      if (!osg_view)
+      {
+         operation.completion.Complete();
+
+         return;
+      }
+
+      if (!RendersOSGView(render_thread, osg_view))
+      {
+         ForwardOperation(
+            osg_view,
+            std::move(operation));
+
+         return;
+      }
+   }
+
+   const auto wait_us =
+      static_cast< uint64_t >(
+         std::chrono::duration_cast< std::chrono::microseconds >(
+            std::chrono::steady_clock::now() -
+            operation.added).count());
+
+   // only the render thread writes the statistics
+   render_thread.operations_executed.fetch_add(
+      1,
+      std::memory_order_relaxed);
+   render_thread.operations_total_wait_us.fetch_add(
+      wait_us,
+      std::memory_order_relaxed);
+
+   if (wait_us >
+       render_thread.operations_max_wait_us.load(
+         std::memory_order_relaxed))
+   {
+      render_thread.operations_max_wait_us.store(
+         wait_us,
+         std::memory_order_relaxed);
+   }
+
+   operation.task();
+   operation.completion.Complete();
+}
+
+void DrawOSGViews(
+   const std::vector< std::shared_ptr< OSGView > > & osg_views )
+{
+   for (const auto & osg_view : osg_views)
+   {
+      osg_view->DrawFrame();
+   }
+
+   for (const auto & osg_view : osg_views)
+   {
+      osg_view->PostRender();
+   }
+}
+
+size_t ExecuteOperations(
+   RenderThread & render_thread,
+   const std::chrono::microseconds budget )
+{
+   const auto time_start =
+      std::chrono::steady_clock::now();
+
+   Operation operation;
+
+   if (render_thread.operations.Pop(operation))
+   {
+      MakeRenderThreadGLContextCurrent();
+
+      do
+      {
+         ExecuteOperation(
+            render_thread,
+            operation);
+      }
+      while (
+         std::chrono::steady_clock::now() - time_start < budget &&
+         render_thread.operations.Pop(operation));
+
+      ReleaseRenderThreadGLContextCurrent();
+   }
+
+   return render_thread.operations.Size();
+}
+
+// the frame culled in one pass is drawn in the next, while the frame
+// after it is culled.  expects the views of the render thread locked.
+void RenderPipelinedOSGViews(
+   RenderThread & render_thread,
+   const bool parallel_cull )
+{
+   auto & frame_osg_views =
+      render_thread.frame_osg_views;
+   auto & draw_osg_views =
+      render_thread.draw_osg_views;
+
+   const auto prepare_start =
+      std::chrono::steady_clock::now();
+
+   for (const auto & osg_view : render_thread.osg_views)
    {
       const auto shared_osg_view =
          osg_view.lock();
 
       if (shared_osg_view)
       {
-         shared_osg_view->PreRender();
-         shared_osg_view->Render();
-         shared_osg_view->PostRender();
+         // the frame culled in the previous pass is drawn in this one
+         if (shared_osg_view->FramePending())
+         {
+            draw_osg_views.emplace_back(
+               shared_osg_view);
+         }
+
+         // views that have not changed are not prepared or culled
+         if (shared_osg_view->NeedsRender())
+         {
+            shared_osg_view->PreRender();
+
+            if (shared_osg_view->PrepareFrame())
+            {
+               frame_osg_views.emplace_back(
+                  shared_osg_view);
+            }
+         }
+      }
+   }
+
+   const auto update_start =
+      std::chrono::steady_clock::now();
+
+   // the updates change the scene graphs the pending frames are drawn
+   // from, so they run before any frame is drawn
+   if (parallel_cull)
+   {
+      worker_pool::ParallelFor(
+         frame_osg_views.size(),
+         [ & frame_osg_views ] ( const size_t index )
+         {
+            frame_osg_views[index]->UpdateFrame();
+         });
+   }
+   else
+   {
+      for (const auto & osg_view : frame_osg_views)
+      {
+         osg_view->UpdateFrame();
+      }
+   }
+
+   const auto cull_start =
+      std::chrono::steady_clock::now();
+
+   worker_pool::JobHandle cull;
+
+   if (parallel_cull)
+   {
+      // the next frames are culled on the worker pool while this
+      // thread submits the draws of the frames culled previously
+      cull =
+         worker_pool::Dispatch(
+            frame_osg_views.size(),
+            [ & frame_osg_views ] ( const size_t index )
+            {
+               frame_osg_views[index]->CullFrame();
+            });
+   }
+   else
+   {
+      for (const auto & osg_view : frame_osg_views)
+      {
+         osg_view->CullFrame();
+      }
+   }
+
+   const auto draw_start =
+      std::chrono::steady_clock::now();
+
+   DrawOSGViews(
+      draw_osg_views);
+
+   const auto cull_wait_start =
+      std::chrono::steady_clock::now();
+
+   worker_pool::Wait(
+      cull);
+
+   const auto cull_end =
+      std::chrono::steady_clock::now();
+
+   for (const auto & osg_view : frame_osg_views)
+   {
+      osg_view->SwapFrame();
+   }
+
+   telemetry::Record(
+      telemetry::Phase::PREPARE_STAGE,
+      update_start - prepare_start);
+   telemetry::Record(
+      telemetry::Phase::UPDATE_STAGE,
+      cull_start - update_start);
+   telemetry::Record(
+      telemetry::Phase::CULL_STAGE,
+      cull ?
+      cull_end - cull_start :
+      draw_start - cull_start);
+   telemetry::Record(
+      telemetry::Phase::DRAW_STAGE,
+      cull_wait_start - draw_start);
+   telemetry::Record(
+      telemetry::Phase::CULL_WAIT,
+      cull_end - cull_wait_start);
+
+   draw_osg_views.clear();
+}
+
+// every frame is culled and drawn in the same pass.  expects
+// the views of the render thread locked.
+void RenderUnpipelinedOSGViews(
+   RenderThread & render_thread,
+   const bool parallel_cull )
+{
+   auto & frame_osg_views =
+      render_thread.frame_osg_views;
+   auto & draw_osg_views =
+      render_thread.draw_osg_views;
+
+   for (const auto & osg_view : render_thread.osg_views)
+   {
+      auto shared_osg_view =
+         osg_view.lock();
+
+      if (shared_osg_view)
+      {
+         // a frame left pending when the pipelined render was turned
+         // off is drawn first, as rendering the view would drop it
+         if (shared_osg_view->FramePending())
+         {
+            draw_osg_views.emplace_back(
+               shared_osg_view);
+         }
+
+         // views that have not changed are skipped entirely
+         if (shared_osg_view->NeedsRender())
+         {
+            frame_osg_views.emplace_back(
+               std::move(shared_osg_view));
+         }
       }
    }
+
+   DrawOSGViews(
+      draw_osg_views);
+
+   draw_osg_views.clear();
+
+   if (parallel_cull)
+   {
+      for (const auto & osg_view : frame_osg_views)
+      {
+         osg_view->PreRender();
+         osg_view->PrepareFrame();
+      }
+
+      // update and cull are cpu only work, so the views are updated
+      // and culled on the worker pool while this thread only executes
+      // the gl work of the views
+      worker_pool::ParallelFor(
+         frame_osg_views.size(),
+         [ & frame_osg_views ] ( const size_t index )
+         {
+            frame_osg_views[index]->UpdateFrame();
+            frame_osg_views[index]->CullFrame();
+         });
+
+      for (const auto & osg_view : frame_osg_views)
+      {
+         osg_view->SwapFrame();
+      }
+
+      DrawOSGViews(
+         frame_osg_views);
+   }
+   else
+   {
+      for (const auto & osg_view : frame_osg_views)
+      {
+         osg_view->PreRender();
+         osg_view->Render();
+         osg_view->PostRender();
+      }
+   }
+}
+
+void RenderOSGViews(
+   RenderThread & render_thread )
+{
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      render_thread.osg_views_mutex };
+#else
+   std::lock_guard< decltype(render_thread.osg_views_mutex) > lock {
+      render_thread.osg_views_mutex };
+#endif
+
+   const bool parallel_cull {
+      parallel_cull_.load(
+         std::memory_order_relaxed) };
+
+   if (pipelined_render_.load(std::memory_order_relaxed))
+   {
+      RenderPipelinedOSGViews(
+         render_thread,
+         parallel_cull);
+   }
+   else
+   {
+      RenderUnpipelinedOSGViews(
+         render_thread,
+         parallel_cull);
+   }
+
+   render_thread.frame_osg_views.clear();
 }
 
-void RenderLoop( )
+void RenderLoop(
+   RenderThread & render_thread )
 {
-   while (!quit_render_thread_)
+   render_thread.qthread =
+      QThread::currentThread();
+
+   FramePacer frame_pacer;
+
+   while (!render_thread.quit)
    {
-      const auto time_start =
+      frame_pacer.SetTargetFrameRate(
+         target_frame_rate_.load(
+            std::memory_order_relaxed));
+      frame_pacer.SetRenderLate(
+         render_late_.load(
+            std::memory_order_relaxed));
+
+      frame_pacer.BeginFrame();
+
+      const auto operations_start =
          std::chrono::steady_clock::now();
 
-      ExecuteOperation();
+      ExecuteOperations(
+         render_thread,
+         std::chrono::microseconds {
+            operation_time_budget_us_.load(
+               std::memory_order_relaxed) });
+
+      const auto process_events_start =
+         std::chrono::steady_clock::now();
 
       QEventLoop().processEvents(
          QEventLoop::AllEvents);
 
-      RenderOSGViews();
-
-      const auto time_end =
+      const auto process_events_end =
          std::chrono::steady_clock::now();
 
-      const auto time_delta =
-         time_end - time_start;
+      telemetry::Record(
+         telemetry::Phase::OPERATIONS,
+         process_events_start - operations_start);
+      telemetry::Record(
+         telemetry::Phase::PROCESS_EVENTS,
+         process_events_end - process_events_start);
 
-      const std::chrono::milliseconds
-         frame_rate { 33 };
+      RenderOSGViews(
+         render_thread);
 
-      if (time_delta < frame_rate)
-      {
-         std::this_thread::sleep_for(
-            frame_rate - time_delta);
-      }
+      frame_pacer.EndFrame();
+
+      render_thread.frames.store(
+         frame_pacer.Frames(),
+         std::memory_order_relaxed);
+      render_thread.missed_deadlines.store(
+         frame_pacer.MissedDeadlines(),
+         std::memory_order_relaxed);
+
+      telemetry::Record(
+         telemetry::Phase::FRAME,
+         frame_pacer.LastFrameCost());
+   }
+
+   render_thread.accepting.store(
+      false);
 
-      std::cout
-         << "Frame time "
-         << std::chrono::duration_cast<
-               std::chrono::milliseconds >(time_delta).count()
-         << " ms"
-         << std::endl;
+   while (render_thread.pushing.load())
+   {
+      std::this_thread::yield();
    }
 
-   while (ExecuteOperation());
+   while (
+      ExecuteOperations(
+         render_thread,
+         std::chrono::microseconds::zero()));
+}
+
+std::unique_ptr< RenderThread > StartRenderThread( )
+{
+   auto render_thread =
+      std::make_unique< RenderThread >();
+
+   render_thread->thread =
+      std::thread {
+         &RenderLoop,
+         std::ref(*render_thread) };
+
+   return render_thread;
+}
+
+void StopRenderThread(
+   RenderThread & render_thread )
+{
+   render_thread.quit = true;
+
+   render_thread.thread.join();
+}
+
+std::future< void > PushOperation(
+   RenderThread & render_thread,
+   RenderTask operation )
+{
+   std::future< void > completed;
+
+   PushOperation(
+      render_thread,
+      Operation {
+         std::move(operation),
+         RenderTaskCompletion::Create(
+            completed),
+         std::chrono::steady_clock::now() });
+
+   return completed;
 }
 
 void Start(
-   std::any hidden_gl_context ) noexcept
+   std::any hidden_gl_context,
+   const size_t render_thread_count ) noexcept
 {
 #if _has_cxx_class_template_argument_deduction
    std::lock_guard lock {
@@ -129,16 +651,52 @@ void Start(
       render_thread_mutex_ };
 #endif
 
-   if (render_thread_.get_id() ==
-       std::thread::id { })
+   if (!RenderThreadCount())
    {
-      render_thread_ =
-         std::thread {
-            &RenderLoop };
+      std::vector<
+         std::unique_ptr< RenderThread > > render_threads;
 
-      AddOperation(
-         &InitHiddenGLContext,
-         std::move(hidden_gl_context)).wait();
+      render_threads.emplace_back(
+         StartRenderThread());
+
+      // a single render thread draws every view, so its contexts
+      // share the context id of the hidden context without taking
+      // turns with other render threads for the gl objects
+      PushOperation(
+         *render_threads.front(),
+         [ hidden_gl_context = std::move(hidden_gl_context),
+           share_context_id = render_thread_count == 1 ] ( )
+         {
+            InitHiddenGLContext(
+               hidden_gl_context,
+               share_context_id);
+         }).wait();
+      PushOperation(
+         *render_threads.front(),
+         &InitRenderThreadGLContext).wait();
+
+      // the hidden context must exist before the
+      // other render threads can share with it
+      for (size_t i { 1 }; i < render_thread_count; ++i)
+      {
+         render_threads.emplace_back(
+            StartRenderThread());
+
+         PushOperation(
+            *render_threads.back(),
+            &InitRenderThreadGLContext).wait();
+      }
+
+#if _has_cxx_class_template_argument_deduction
+      std::unique_lock threads_lock {
+         render_threads_mutex_ };
+#else
+      std::unique_lock< decltype(render_threads_mutex_) > threads_lock {
+         render_threads_mutex_ };
+#endif
+
+      render_threads_ =
+         std::move(render_threads);
    }
 }
 
@@ -152,141 +710,595 @@ void Stop( ) noexcept
       render_thread_mutex_ };
 #endif
 
-   if (render_thread_.get_id() !=
-       std::thread::id { })
+   std::vector<
+      std::unique_ptr< RenderThread > > render_threads;
+
    {
-      AddOperation(
+#if _has_cxx_class_template_argument_deduction
+      std::unique_lock threads_lock {
+         render_threads_mutex_ };
+#else
+      std::unique_lock< decltype(render_threads_mutex_) > threads_lock {
+         render_threads_mutex_ };
+#endif
+
+      render_threads.swap(
+         render_threads_);
+   }
+
+   if (!render_threads.empty())
+   {
+      // the hidden context is shared by all other
+      // render threads so it must be released last
+      for (size_t i { render_threads.size() }; i-- > 1; )
+      {
+         PushOperation(
+            *render_threads[i],
+            &ReleaseRenderThreadGLContext).wait();
+
+         StopRenderThread(
+            *render_threads[i]);
+      }
+
+      PushOperation(
+         *render_threads.front(),
+         &ReleaseRenderThreadGLContext).wait();
+      PushOperation(
+         *render_threads.front(),
          &ReleaseHiddenGLContext).wait();
 
-      quit_render_thread_ = true;
+      StopRenderThread(
+         *render_threads.front());
+   }
+}
+
+std::shared_lock< std::shared_mutex > LockRenderThreads( )
+{
+   return
+      std::shared_lock< std::shared_mutex > {
+         render_threads_mutex_ };
+}
+
+size_t RenderThreadCount( ) noexcept
+{
+   const auto lock =
+      LockRenderThreads();
+
+   return render_threads_.size();
+}
+
+size_t RenderThreadOf(
+   const QObject & object ) noexcept
+{
+   const auto lock =
+      LockRenderThreads();
+
+   const auto render_thread =
+      std::find_if(
+         render_threads_.cbegin(),
+         render_threads_.cend(),
+         [ qthread = object.thread() ] (
+            const auto & render_thread )
+         {
+            return render_thread->qthread == qthread;
+         });
+
+   return
+      render_thread != render_threads_.cend() ?
+      static_cast< size_t >(
+         std::distance(render_threads_.cbegin(), render_thread)) :
+      0;
+}
+
+// the functions below expect the render threads to be locked
+size_t FindOSGView(
+   const std::shared_ptr< OSGView > & osg_view )
+{
+   size_t render_thread_index { 0 };
+
+   for (; render_thread_index < render_threads_.size();
+        ++render_thread_index)
+   {
+      auto & render_thread =
+         *render_threads_[render_thread_index];
 
-      render_thread_.join();
+#if _has_cxx_class_template_argument_deduction
+      std::lock_guard lock {
+         render_thread.osg_views_mutex };
+#else
+      std::lock_guard< decltype(render_thread.osg_views_mutex) > lock {
+         render_thread.osg_views_mutex };
+#endif
+
+      const auto registered_view =
+         std::find_if(
+            render_thread.osg_views.cbegin(),
+            render_thread.osg_views.cend(),
+            [ & osg_view ] ( const auto & view )
+            {
+               return IsSameOSGView(view, osg_view);
+            });
+
+      if (registered_view != render_thread.osg_views.cend())
+      {
+         break;
+      }
    }
+
+   return render_thread_index;
 }
 
-bool RegisterOSGView(
-   std::weak_ptr< OSGView > osg_view ) noexcept
+size_t LeastLoadedRenderThread( )
 {
+   size_t least_loaded { 0 };
+   size_t least_loaded_views { static_cast< size_t >(-1) };
+
+   for (size_t i { 0 }; i < render_threads_.size(); ++i)
+   {
+      auto & render_thread =
+         *render_threads_[i];
+
 #if _has_cxx_class_template_argument_deduction
-   std::lock_guard lock {
-      osg_views_mutex_ };
+      std::lock_guard lock {
+         render_thread.osg_views_mutex };
 #else
-   std::lock_guard< decltype(osg_views_mutex_) > lock {
-      osg_views_mutex_ };
+      std::lock_guard< decltype(render_thread.osg_views_mutex) > lock {
+         render_thread.osg_views_mutex };
 #endif
 
-   const auto registered_view =
-      std::find_if(
-         osg_views_.cbegin(),
-         osg_views_.cend(),
-         [ shared_osg_view = osg_view.lock() ] (
-            const auto & view )
-         {
-            const auto shared_view =
-               view.lock();
+      if (render_thread.osg_views.size() < least_loaded_views)
+      {
+         least_loaded = i;
+         least_loaded_views = render_thread.osg_views.size();
+      }
+   }
 
-            return
-               shared_view &&
-               shared_osg_view &&
-               shared_view == shared_osg_view;
-         });
+   return least_loaded;
+}
+
+bool AttachOSGView(
+   std::weak_ptr< OSGView > osg_view,
+   RenderThread & render_thread )
+{
+   const auto shared_osg_view =
+      osg_view.lock();
+
+   // views receive their events on the render thread
+   // that renders them, so the affinity must follow
+   if (shared_osg_view->thread() != render_thread.qthread)
+   {
+      if (shared_osg_view->thread() != QThread::currentThread())
+      {
+         return false;
+      }
+
+      shared_osg_view->moveToThread(
+         render_thread.qthread);
+   }
+
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      render_thread.osg_views_mutex };
+#else
+   std::lock_guard< decltype(render_thread.osg_views_mutex) > lock {
+      render_thread.osg_views_mutex };
+#endif
 
    return
-      registered_view == osg_views_.cend() &&
-      osg_views_.emplace(
-         osg_views_.cend(),
+      render_thread.osg_views.emplace(
+         render_thread.osg_views.cend(),
          std::move(osg_view)) !=
-      osg_views_.cend();
+      render_thread.osg_views.cend();
 }
 
-bool UnregisterOSGView(
-   std::weak_ptr< OSGView > osg_view ) noexcept
+bool DetachOSGView(
+   const std::shared_ptr< OSGView > & osg_view,
+   RenderThread & render_thread )
 {
 #if _has_cxx_class_template_argument_deduction
    std::lock_guard lock {
-      osg_views_mutex_ };
+      render_thread.osg_views_mutex };
 #else
-   std::lock_guard< decltype(osg_views_mutex_) > lock {
-      osg_views_mutex_ };
+   std::lock_guard< decltype(render_thread.osg_views_mutex) > lock {
+      render_thread.osg_views_mutex };
 #endif
 
    const auto current_size =
-      osg_views_.size();
+      render_thread.osg_views.size();
 
-   osg_views_.remove_if(
-      [ shared_osg_view = osg_view.lock() ] (
-         const auto & view )
+   render_thread.osg_views.remove_if(
+      [ & osg_view ] ( const auto & view )
       {
-         const auto shared_view =
-            view.lock();
-
-         return
-            shared_view &&
-            shared_osg_view &&
-            shared_view == shared_osg_view;
+         return IsSameOSGView(view, osg_view);
       });
 
-   return current_size != osg_views_.size();
+   return current_size != render_thread.osg_views.size();
 }
 
-std::future< void > AddOperation(
-   std::function< void ( ) > operation ) noexcept
+// moves the operations for the view still queued on the source render
+// thread to the target in the order they were pushed.  the render
+// threads must be locked exclusively, so no operation is pushed in
+// the meantime, and only the source render thread may pop its queue.
+void HandOverOperations(
+   RenderThread & source,
+   RenderThread & target,
+   const std::shared_ptr< OSGView > & osg_view )
 {
+   std::vector< Operation > remaining;
+
+   Operation operation;
+
+   while (source.operations.Pop(operation))
+   {
+      if (operation.view_operation &&
+          IsSameOSGView(operation.osg_view, osg_view))
+      {
+         PushOperation(
+            target,
+            std::move(operation));
+      }
+      else
+      {
+         remaining.emplace_back(
+            std::move(operation));
+      }
+   }
+
+   for (auto & remaining_operation : remaining)
+   {
+      PushOperation(
+         source,
+         std::move(remaining_operation));
+   }
+}
+
+bool RegisterOSGViewLocked(
+   std::weak_ptr< OSGView > osg_view,
+   const size_t render_thread )
+{
+   const auto shared_osg_view =
+      osg_view.lock();
+
+   return
+      shared_osg_view &&
+      render_thread < render_threads_.size() &&
+      FindOSGView(shared_osg_view) == render_threads_.size() &&
+      AttachOSGView(
+         std::move(osg_view),
+         *render_threads_[render_thread]);
+}
+
+bool RegisterOSGView(
+   std::weak_ptr< OSGView > osg_view ) noexcept
+{
+   const auto lock =
+      LockRenderThreads();
+
+   return
+      RegisterOSGViewLocked(
+         std::move(osg_view),
+         LeastLoadedRenderThread());
+}
+
+bool RegisterOSGView(
+   std::weak_ptr< OSGView > osg_view,
+   const size_t render_thread ) noexcept
+{
+   const auto lock =
+      LockRenderThreads();
+
+   return
+      RegisterOSGViewLocked(
+         std::move(osg_view),
+         render_thread);
+}
+
+bool UnregisterOSGView(
+   std::weak_ptr< OSGView > osg_view ) noexcept
+{
+   const auto lock =
+      LockRenderThreads();
+
+   const auto shared_osg_view =
+      osg_view.lock();
+
+   const auto render_thread =
+      FindOSGView(shared_osg_view);
+
+   return
+      render_thread < render_threads_.size() &&
+      DetachOSGView(
+         shared_osg_view,
+         *render_threads_[render_thread]);
+}
+
+bool MigrateOSGView(
+   std::weak_ptr< OSGView > osg_view,
+   const size_t render_thread ) noexcept
+{
+   const auto lock =
+      LockRenderThreads();
+
+   const auto shared_osg_view =
+      osg_view.lock();
+
+   const auto current_render_thread =
+      FindOSGView(shared_osg_view);
+
+   const bool migrate =
+      render_thread < render_threads_.size() &&
+      current_render_thread < render_threads_.size() &&
+      current_render_thread != render_thread;
+
+   if (migrate)
+   {
+      // executing on the render thread of the view guarantees the
+      // view is not in the middle of a frame and that the affinity
+      // is changed from the thread owning the view.  operations for
+      // the view queued after this one are handed over to the target
+      // ahead of any pushed once the view moved.
+      PushOperation(
+         *render_threads_[current_render_thread],
+         Operation {
+            [ osg_view, render_thread ] ( )
+            {
+               // locked exclusively, so no lookup finds the view in
+               // between leaving one render thread and joining the
+               // other.  the render threads may have been stopped since.
 #if _has_cxx_class_template_argument_deduction
-    std::lock_guard lock {
-      operations_mutex_ };
+               std::unique_lock threads_lock {
+                  render_threads_mutex_ };
 #else
-   std::lock_guard< decltype(operations_mutex_) > lock {
-      operations_mutex_ };
+               std::unique_lock< decltype(render_threads_mutex_) > threads_lock {
+                  render_threads_mutex_ };
 #endif
 
-   auto complete =
-      std::make_shared< std::promise< void > >();
+               const auto shared_osg_view =
+                  osg_view.lock();
+
+               const auto source_render_thread =
+                  FindOSGView(shared_osg_view);
+
+               if (render_thread < render_threads_.size() &&
+                   source_render_thread < render_threads_.size() &&
+                   source_render_thread != render_thread &&
+                   DetachOSGView(
+                      shared_osg_view,
+                      *render_threads_[source_render_thread]) &&
+                   AttachOSGView(
+                      osg_view,
+                      *render_threads_[render_thread]))
+               {
+                  HandOverOperations(
+                     *render_threads_[source_render_thread],
+                     *render_threads_[render_thread],
+                     shared_osg_view);
+               }
+            },
+            RenderTaskCompletion { },
+            std::chrono::steady_clock::now(),
+            osg_view,
+            true });
+   }
+
+   return migrate;
+}
+
+void SetOperationTimeBudget(
+   const std::chrono::microseconds budget ) noexcept
+{
+   operation_time_budget_us_.store(
+      budget.count(),
+      std::memory_order_relaxed);
+}
+
+OperationStatistics GetOperationStatistics(
+   const size_t render_thread_index ) noexcept
+{
+   OperationStatistics statistics;
 
-   auto completed =
-      complete->get_future();
+   const auto lock =
+      LockRenderThreads();
 
-   operations_.push_back(
-      [ complete = std::move(complete),
-        operation = std::move(operation) ] ( ) mutable
+   if (render_thread_index < render_threads_.size())
+   {
+      const auto & render_thread =
+         *render_threads_[render_thread_index];
+
+      statistics.queue_depth =
+         render_thread.operations.Size();
+      statistics.executed =
+         render_thread.operations_executed.load(
+            std::memory_order_relaxed);
+      statistics.max_wait =
+         std::chrono::microseconds {
+            render_thread.operations_max_wait_us.load(
+               std::memory_order_relaxed) };
+
+      if (statistics.executed)
       {
-         operation();
+         statistics.average_wait =
+            std::chrono::microseconds {
+               render_thread.operations_total_wait_us.load(
+                  std::memory_order_relaxed) /
+               statistics.executed };
+      }
+   }
 
-         complete->set_value();
-      });
+   return statistics;
+}
+
+void SetTargetFrameRate(
+   const double frames_per_second ) noexcept
+{
+   target_frame_rate_.store(
+      frames_per_second,
+      std::memory_order_relaxed);
+}
+
+void SetRenderLate(
+   const bool render_late ) noexcept
+{
+   render_late_.store(
+      render_late,
+      std::memory_order_relaxed);
+}
+
+void SetParallelCull(
+   const bool parallel_cull ) noexcept
+{
+   parallel_cull_.store(
+      parallel_cull,
+      std::memory_order_relaxed);
+}
+
+void SetPipelinedRender(
+   const bool pipelined_render ) noexcept
+{
+   pipelined_render_.store(
+      pipelined_render,
+      std::memory_order_relaxed);
+}
+
+FrameStatistics GetFrameStatistics(
+   const size_t render_thread_index ) noexcept
+{
+   FrameStatistics statistics;
+
+   const auto lock =
+      LockRenderThreads();
+
+   if (render_thread_index < render_threads_.size())
+   {
+      const auto & render_thread =
+         *render_threads_[render_thread_index];
+
+      statistics.frames =
+         render_thread.frames.load(
+            std::memory_order_relaxed);
+      statistics.missed_deadlines =
+         render_thread.missed_deadlines.load(
+            std::memory_order_relaxed);
+   }
+
+   return statistics;
+}
+
+std::future< void > AddOperation(
+   RenderTask operation ) noexcept
+{
+   return
+      AddOperation(
+         0,
+         std::move(operation));
+}
+
+std::future< void > AddOperation(
+   const size_t render_thread_index,
+   RenderTask operation ) noexcept
+{
+   const auto lock =
+      LockRenderThreads();
+
+   std::future< void > completed;
+
+   if (render_thread_index < render_threads_.size())
+   {
+      completed =
+         PushOperation(
+            *render_threads_[render_thread_index],
+            std::move(operation));
+   }
+   else
+   {
+      RenderTaskCompletion::Create(
+         completed).Complete();
+   }
 
    return completed;
 }
 
 std::future< void > AddOperation(
-   std::function< void ( const std::any & ) > operation,
-   std::any arguments ) noexcept
+   std::weak_ptr< OSGView > osg_view,
+   RenderTask operation ) noexcept
 {
-#if _has_cxx_class_template_argument_deduction
-    std::lock_guard lock {
-      operations_mutex_ };
-#else
-   std::lock_guard< decltype(operations_mutex_) > lock {
-      operations_mutex_ };
-#endif
+   const auto lock =
+      LockRenderThreads();
 
-   auto complete =
-      std::make_shared< std::promise< void > >();
+   std::future< void > completed;
 
-   auto completed =
-      complete->get_future();
+   auto completion =
+      RenderTaskCompletion::Create(
+         completed);
 
-   operations_.push_back(
-      [ complete = std::move(complete),
-        operation = std::move(operation),
-        arguments = std::move(arguments) ] ( ) mutable
-      {
-         operation(arguments);
+   const auto render_thread_index =
+      FindOSGView(osg_view.lock());
 
-         complete->set_value();
-      });
+   if (render_thread_index < render_threads_.size())
+   {
+      PushOperation(
+         *render_threads_[render_thread_index],
+         Operation {
+            std::move(operation),
+            std::move(completion),
+            std::chrono::steady_clock::now(),
+            std::move(osg_view),
+            true });
+   }
+   else
+   {
+      completion.Complete();
+   }
 
    return completed;
 }
 
+bool PostOperation(
+   RenderTask operation ) noexcept
+{
+   return
+      PostOperation(
+         0,
+         std::move(operation));
+}
+
+bool PostOperation(
+   const size_t render_thread_index,
+   RenderTask operation ) noexcept
+{
+   const auto lock =
+      LockRenderThreads();
+
+   return
+      render_thread_index < render_threads_.size() &&
+      PushOperation(
+         *render_threads_[render_thread_index],
+         Operation {
+            std::move(operation),
+            RenderTaskCompletion { },
+            std::chrono::steady_clock::now() });
+}
+
+bool PostOperation(
+   std::weak_ptr< OSGView > osg_view,
+   RenderTask operation ) noexcept
+{
+   const auto lock =
+      LockRenderThreads();
+
+   const auto render_thread_index =
+      FindOSGView(osg_view.lock());
+
+   return
+      render_thread_index < render_threads_.size() &&
+      PushOperation(
+         *render_threads_[render_thread_index],
+         Operation {
+            std::move(operation),
+            RenderTaskCompletion { },
+            std::chrono::steady_clock::now(),
+            std::move(osg_view),
+            true });
+}
+
 } // namespace render_thread
@@ -1,35 +1,135 @@
 #ifndef _RENDER_THREAD_H_
 #define _RENDER_THREAD_H_
 
+#include "render-task.h"
+
 #if _has_cxx_std_any
 #include <any>
 #else
 #include "stl-ext/any"
 #endif
 
-#include <functional>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <future>
 #include <memory>
 
 class OSGView;
+class QObject;
 
 namespace render_thread
 {
 
+struct OperationStatistics
+{
+   // operations waiting to be executed
+   size_t queue_depth { 0 };
+   uint64_t executed { 0 };
+
+   // time from being added to starting execution
+   std::chrono::microseconds average_wait { 0 };
+   std::chrono::microseconds max_wait { 0 };
+};
+
+struct FrameStatistics
+{
+   uint64_t frames { 0 };
+   // frames that completed after their deadline
+   uint64_t missed_deadlines { 0 };
+};
+
+// starts a pool of render threads.  the first render thread
+// owns the hidden gl context and executes all operations not
+// directed at a specific render thread.  every render thread
+// owns a gl context that shares with the hidden gl context.
+// a single render thread shares the context id of the hidden
+// gl context as well, so the gl objects are compiled once.
 void Start(
-   std::any hidden_gl_context ) noexcept;
+   std::any hidden_gl_context,
+   const size_t render_thread_count = 1 ) noexcept;
 void Stop( ) noexcept;
 
+size_t RenderThreadCount( ) noexcept;
+size_t RenderThreadOf(
+   const QObject & object ) noexcept;
+
+// registers the view with the render thread that currently
+// renders the fewest views.  the view must be unregistered
+// and have affinity to the calling thread or the render thread.
 bool RegisterOSGView(
    std::weak_ptr< OSGView > osg_view ) noexcept;
+bool RegisterOSGView(
+   std::weak_ptr< OSGView > osg_view,
+   const size_t render_thread ) noexcept;
 bool UnregisterOSGView(
    std::weak_ptr< OSGView > osg_view ) noexcept;
+// moves a registered view to another render thread between
+// frames of the render thread currently rendering the view.
+// operations for the view still queued on that render thread
+// are forwarded to the view once it moved.
+bool MigrateOSGView(
+   std::weak_ptr< OSGView > osg_view,
+   const size_t render_thread ) noexcept;
+
+// each frame a render thread drains pending operations until the
+// queue is empty or the budget is spent.  at least one operation
+// is always executed so that progress is guaranteed.
+void SetOperationTimeBudget(
+   const std::chrono::microseconds budget ) noexcept;
+OperationStatistics GetOperationStatistics(
+   const size_t render_thread ) noexcept;
+
+// a frame rate of zero renders frames as fast as possible.  when
+// rendering late each frame starts just early enough to complete
+// by its deadline, based on the measured cost of previous frames.
+void SetTargetFrameRate(
+   const double frames_per_second ) noexcept;
+void SetRenderLate(
+   const bool render_late ) noexcept;
 
+// the views of a render thread are updated and culled on the worker
+// pool, which is the default, or one after the other on the render
+// thread.  takes effect with the next frame of each render thread.
+void SetParallelCull(
+   const bool parallel_cull ) noexcept;
+// a pipelined render thread draws the frames culled in its previous
+// pass while it culls the next ones, which is the default, instead
+// of culling and drawing every frame in the same pass.  a frame still
+// pending when the pipeline is turned off is drawn in the next pass.
+void SetPipelinedRender(
+   const bool pipelined_render ) noexcept;
+FrameStatistics GetFrameStatistics(
+   const size_t render_thread ) noexcept;
+
+std::future< void > AddOperation(
+   RenderTask operation ) noexcept;
 std::future< void > AddOperation(
-   std::function< void ( ) > operation ) noexcept;
+   const size_t render_thread,
+   RenderTask operation ) noexcept;
+// executes the operation on the render thread that renders the view
+// when the operation is executed, which keeps the view alive while
+// the operation executes.  an operation for a view that is released
+// or no longer registered is completed without being executed.
 std::future< void > AddOperation(
-   std::function< void ( const std::any & ) > operation,
-   std::any arguments ) noexcept;
+   std::weak_ptr< OSGView > osg_view,
+   RenderTask operation ) noexcept;
+
+// fire and forget operations do not allocate a completion state.
+// once the queues are warmed up posting an operation that fits
+// in the render task storage does not allocate from the heap.
+// returns false when the operation is rejected, as the render
+// thread is stopping or the view is not registered, in which case
+// it is never executed.  an added operation that is rejected is
+// completed without being executed.
+bool PostOperation(
+   RenderTask operation ) noexcept;
+bool PostOperation(
+   const size_t render_thread,
+   RenderTask operation ) noexcept;
+bool PostOperation(
+   std::weak_ptr< OSGView > osg_view,
+   RenderTask operation ) noexcept;
 
 } // namespace rt
 
@@ -0,0 +1,250 @@
+#include "swap-chain.h"
+
+#include <osg/FrameBufferObject>
+
+#include <algorithm>
+#include <limits>
+
+// a consumer holding a buffer this long is not going to release
+// one in time for the next frame, so waiting on it skips frames
+static const std::chrono::milliseconds HOLD_THRESHOLD { 50 };
+// period over which a spare buffer must have gone unused to be freed
+static const std::chrono::seconds IDLE_PERIOD { 5 };
+
+SwapChain::SwapChain(
+   CreateFrameBuffer create_frame_buffer,
+   const size_t minimum_depth,
+   const size_t maximum_depth ) noexcept :
+create_frame_buffer_ { std::move(create_frame_buffer) },
+minimum_depth_ { std::max< size_t >(minimum_depth, 1) },
+maximum_depth_ { std::max(minimum_depth, maximum_depth) },
+idle_period_start_ { Clock::now() },
+idle_period_minimum_free_ { std::numeric_limits< size_t >::max() },
+depth_ { 0 },
+occupancy_ { 0 },
+skipped_frames_ { 0 },
+grown_ { 0 },
+shrunk_ { 0 }
+{
+}
+
+SwapChain::~SwapChain( ) noexcept
+{
+}
+
+void SwapChain::SetDepth(
+   const size_t minimum_depth,
+   const size_t maximum_depth ) noexcept
+{
+   minimum_depth_ =
+      std::max< size_t >(minimum_depth, 1);
+   maximum_depth_ =
+      std::max(minimum_depth_.load(), maximum_depth);
+}
+
+size_t SwapChain::MinimumDepth( ) const noexcept
+{
+   return
+      minimum_depth_;
+}
+
+void SwapChain::Fill( ) noexcept
+{
+   while (buffers_.size() < minimum_depth_ &&
+          Grow())
+   {
+   }
+}
+
+SwapChain::FrameBuffer SwapChain::Acquire( ) noexcept
+{
+   FrameBuffer frame_buffer { ColorBuffer { }, nullptr };
+
+   const auto now =
+      Clock::now();
+
+   auto buffer =
+      std::find_if(
+         buffers_.begin(),
+         buffers_.end(),
+         [ ] ( const auto & buffer )
+         {
+            return !buffer.second.acquired;
+         });
+
+   if (buffer == buffers_.end() &&
+       buffers_.size() < maximum_depth_ &&
+       (buffers_.size() < minimum_depth_ ||
+        LongestHold(now) >= HOLD_THRESHOLD) &&
+       Grow())
+   {
+      buffer =
+         std::find_if(
+            buffers_.begin(),
+            buffers_.end(),
+            [ ] ( const auto & buffer )
+            {
+               return !buffer.second.acquired;
+            });
+
+      ++grown_;
+   }
+
+   if (buffer != buffers_.end())
+   {
+      buffer->second.acquired = true;
+      buffer->second.acquired_time = now;
+
+      frame_buffer.first = buffer->first;
+      frame_buffer.second = buffer->second.frame_buffer;
+
+      ++occupancy_;
+   }
+   else
+   {
+      ++skipped_frames_;
+   }
+
+   idle_period_minimum_free_ =
+      std::min(
+         idle_period_minimum_free_,
+         buffers_.size() + retired_buffers_.size() - occupancy_);
+
+   Shrink(
+      now);
+
+   return frame_buffer;
+}
+
+void SwapChain::Release(
+   const ColorBuffer & color_buffer ) noexcept
+{
+   const auto buffer =
+      buffers_.find(
+         color_buffer);
+
+   // buffers of a previous chain may still be in flight
+   if (buffer != buffers_.end() &&
+       buffer->second.acquired)
+   {
+      buffer->second.acquired = false;
+
+      --occupancy_;
+   }
+   else
+   {
+      const auto retired_buffer =
+         retired_buffers_.find(
+            color_buffer);
+
+      if (retired_buffer != retired_buffers_.end())
+      {
+         retired_buffers_.erase(
+            retired_buffer);
+
+         --occupancy_;
+      }
+   }
+}
+
+void SwapChain::Retire( ) noexcept
+{
+   for (auto & buffer : buffers_)
+   {
+      if (buffer.second.acquired)
+      {
+         retired_buffers_.emplace(
+            buffer.first,
+            std::move(buffer.second));
+      }
+   }
+
+   buffers_.clear();
+
+   depth_ = 0;
+
+   idle_period_start_ = Clock::now();
+   idle_period_minimum_free_ = std::numeric_limits< size_t >::max();
+}
+
+SwapChainStatistics SwapChain::Statistics( ) const noexcept
+{
+   SwapChainStatistics statistics;
+
+   statistics.depth = depth_;
+   statistics.occupancy = occupancy_;
+   statistics.skipped_frames = skipped_frames_;
+   statistics.grown = grown_;
+   statistics.shrunk = shrunk_;
+
+   return statistics;
+}
+
+bool SwapChain::Grow( ) noexcept
+{
+   const auto frame_buffer =
+      create_frame_buffer_();
+
+   const bool grown {
+      frame_buffer.second &&
+      buffers_.emplace(
+         frame_buffer.first,
+         Buffer { frame_buffer.second, false, Clock::time_point { } }).second };
+
+   depth_ = buffers_.size();
+
+   return grown;
+}
+
+void SwapChain::Shrink(
+   const Clock::time_point now ) noexcept
+{
+   if (now - idle_period_start_ >= IDLE_PERIOD)
+   {
+      if (idle_period_minimum_free_ != 0 &&
+          idle_period_minimum_free_ != std::numeric_limits< size_t >::max() &&
+          buffers_.size() > minimum_depth_)
+      {
+         // buffers are handed out lowest id first, so
+         // the highest free one is the least used one
+         const auto buffer =
+            std::find_if(
+               buffers_.rbegin(),
+               buffers_.rend(),
+               [ ] ( const auto & buffer )
+               {
+                  return !buffer.second.acquired;
+               });
+
+         buffers_.erase(
+            std::next(buffer).base());
+
+         depth_ = buffers_.size();
+
+         ++shrunk_;
+      }
+
+      idle_period_start_ = now;
+      idle_period_minimum_free_ = std::numeric_limits< size_t >::max();
+   }
+}
+
+SwapChain::Clock::duration SwapChain::LongestHold(
+   const Clock::time_point now ) const noexcept
+{
+   Clock::duration longest_hold {
+      Clock::duration::zero() };
+
+   for (const auto & buffer : buffers_)
+   {
+      if (buffer.second.acquired)
+      {
+         longest_hold =
+            std::max(
+               longest_hold,
+               now - buffer.second.acquired_time);
+      }
+   }
+
+   return longest_hold;
+}
@@ -0,0 +1,113 @@
+#ifndef _SWAP_CHAIN_H_
+#define _SWAP_CHAIN_H_
+
+#include "color-buffer.h"
+
+#include <osg/ref_ptr>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <utility>
+
+namespace osg
+{
+class FrameBufferObject;
+}
+
+struct SwapChainStatistics
+{
+   // buffers currently allocated
+   size_t depth { 0 };
+   // buffers acquired and not yet released by the consumer
+   size_t occupancy { 0 };
+   // frames not rendered because every buffer was in use
+   uint64_t skipped_frames { 0 };
+
+   uint64_t grown { 0 };
+   uint64_t shrunk { 0 };
+};
+
+// the color buffers a view renders into and hands to its consumer.
+// when no buffer is free and the consumer has held one for longer
+// than the hold threshold the chain grows up to its maximum depth.
+// a chain that always had a buffer to spare over the idle period
+// shrinks by one buffer down to its minimum depth.  acquire and
+// release must be called on the thread that renders the view, with
+// the context of the view current when acquiring.
+class SwapChain final
+{
+public:
+   using Clock = std::chrono::steady_clock;
+   using FrameBuffer =
+      std::pair< ColorBuffer, osg::ref_ptr< osg::FrameBufferObject > >;
+   using CreateFrameBuffer =
+      std::function< FrameBuffer ( ) >;
+
+   SwapChain(
+      CreateFrameBuffer create_frame_buffer,
+      const size_t minimum_depth,
+      const size_t maximum_depth ) noexcept;
+   ~SwapChain( ) noexcept;
+
+   SwapChain( const SwapChain & ) noexcept = delete;
+   SwapChain & operator = ( const SwapChain & ) noexcept = delete;
+
+   void SetDepth(
+      const size_t minimum_depth,
+      const size_t maximum_depth ) noexcept;
+   size_t MinimumDepth( ) const noexcept;
+
+   // allocates buffers up to the minimum depth
+   void Fill( ) noexcept;
+
+   // the returned frame buffer is null when no buffer is available
+   FrameBuffer Acquire( ) noexcept;
+   void Release(
+      const ColorBuffer & color_buffer ) noexcept;
+
+   // buffers that can no longer be rendered to are replaced by new
+   // ones.  the ones held by the consumer are freed once released.
+   void Retire( ) noexcept;
+
+   SwapChainStatistics Statistics( ) const noexcept;
+
+private:
+   struct Buffer
+   {
+      osg::ref_ptr< osg::FrameBufferObject > frame_buffer;
+
+      bool acquired;
+      Clock::time_point acquired_time;
+   };
+
+   bool Grow( ) noexcept;
+   void Shrink(
+      const Clock::time_point now ) noexcept;
+
+   Clock::duration LongestHold(
+      const Clock::time_point now ) const noexcept;
+
+   const CreateFrameBuffer create_frame_buffer_;
+
+   std::map< ColorBuffer, Buffer > buffers_;
+   std::map< ColorBuffer, Buffer > retired_buffers_;
+
+   std::atomic< size_t > minimum_depth_;
+   std::atomic< size_t > maximum_depth_;
+
+   Clock::time_point idle_period_start_;
+   size_t idle_period_minimum_free_;
+
+   std::atomic< size_t > depth_;
+   std::atomic< size_t > occupancy_;
+   std::atomic< uint64_t > skipped_frames_;
+   std::atomic< uint64_t > grown_;
+   std::atomic< uint64_t > shrunk_;
+
+};
+
+#endif // _SWAP_CHAIN_H_
@@ -0,0 +1,190 @@
+#include "test.h"
+
+#include "../block-pool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using Pool =
+   BlockPool< 48, 16 >;
+
+void TestRecycling( )
+{
+   const auto first =
+      Pool::Allocate();
+   const auto second =
+      Pool::Allocate();
+
+   CHECK(first);
+   CHECK(second);
+   CHECK(first != second);
+   CHECK(reinterpret_cast< uintptr_t >(first) % 16 == 0);
+   CHECK(reinterpret_cast< uintptr_t >(second) % 16 == 0);
+
+   Pool::Release(first);
+   Pool::Release(second);
+
+   const auto allocations =
+      test::HeapAllocations();
+
+   // the free list hands out the last released block first
+   const auto third =
+      Pool::Allocate();
+   const auto fourth =
+      Pool::Allocate();
+
+   CHECK(test::HeapAllocations() == allocations);
+   CHECK(third == second);
+   CHECK(fourth == first);
+
+   Pool::Release(third);
+   Pool::Release(fourth);
+}
+
+// pools of different sizes do not share blocks
+void TestSeparatePools( )
+{
+   using OtherPool =
+      BlockPool< 64, 16 >;
+
+   const auto block =
+      Pool::Allocate();
+
+   Pool::Release(block);
+
+   const auto other_block =
+      OtherPool::Allocate();
+
+   CHECK(other_block != block);
+
+   OtherPool::Release(other_block);
+}
+
+// blocks released on other threads are recycled as well
+void TestReleaseFromOtherThreads( )
+{
+   constexpr size_t BLOCKS { 64 };
+
+   std::vector< void * > blocks;
+
+   for (size_t i { 0 }; i < BLOCKS; ++i)
+   {
+      blocks.emplace_back(
+         Pool::Allocate());
+   }
+
+   std::vector< std::thread > releasers;
+
+   for (size_t i { 0 }; i < 4; ++i)
+   {
+      releasers.emplace_back(
+         [ & blocks, i ] ( )
+         {
+            for (size_t block { i }; block < BLOCKS; block += 4)
+            {
+               Pool::Release(
+                  blocks[block]);
+            }
+         });
+   }
+
+   for (auto & releaser : releasers)
+   {
+      releaser.join();
+   }
+
+   const auto allocations =
+      test::HeapAllocations();
+
+   for (size_t i { 0 }; i < BLOCKS; ++i)
+   {
+      blocks[i] = Pool::Allocate();
+   }
+
+   CHECK(test::HeapAllocations() == allocations);
+
+   for (const auto block : blocks)
+   {
+      Pool::Release(block);
+   }
+}
+
+void TestAllocator( )
+{
+   BlockPoolAllocator< uint64_t > allocator;
+
+   const auto single =
+      allocator.allocate(1);
+
+   allocator.deallocate(single, 1);
+
+   CHECK(allocator.allocate(1) == single);
+
+   allocator.deallocate(single, 1);
+
+   // arrays fall back to the heap
+   const auto allocations =
+      test::HeapAllocations();
+
+   const auto array =
+      allocator.allocate(4);
+
+   CHECK(test::HeapAllocations() == allocations + 1);
+
+   allocator.deallocate(array, 4);
+
+   CHECK(allocator == BlockPoolAllocator< char > { });
+   CHECK(!(allocator != BlockPoolAllocator< char > { }));
+
+   // the shared state of allocate shared comes from the pool
+   std::weak_ptr< int > released;
+
+   {
+      const auto value =
+         std::allocate_shared< int >(
+            BlockPoolAllocator< int > { },
+            42);
+
+      released = value;
+
+      CHECK(*value == 42);
+   }
+
+   CHECK(released.expired());
+
+   // the weak reference holds on to the shared state
+   released.reset();
+
+   const auto recycled_allocations =
+      test::HeapAllocations();
+
+   {
+      const auto value =
+         std::allocate_shared< int >(
+            BlockPoolAllocator< int > { },
+            7);
+
+      CHECK(*value == 7);
+   }
+
+   CHECK(test::HeapAllocations() == recycled_allocations);
+}
+
+} // namespace
+
+int main( )
+{
+   TestRecycling();
+   TestSeparatePools();
+   TestReleaseFromOtherThreads();
+   TestAllocator();
+
+   return
+      test::Result();
+}
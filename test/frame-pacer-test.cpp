@@ -0,0 +1,133 @@
+#include "test.h"
+
+#include "../frame-pacer.h"
+
+#include <chrono>
+#include <thread>
+
+namespace
+{
+
+using Clock = FramePacer::Clock;
+
+// the pacer is only checked against lower bounds on time, as
+// a loaded machine may run any frame later than its deadline
+void TestUnpaced( )
+{
+   FramePacer frame_pacer;
+
+   for (int i { 0 }; i < 10; ++i)
+   {
+      frame_pacer.BeginFrame();
+      frame_pacer.EndFrame();
+   }
+
+   CHECK(frame_pacer.Frames() == 10);
+   CHECK(frame_pacer.MissedDeadlines() == 0);
+}
+
+void TestPaced( )
+{
+   FramePacer frame_pacer;
+
+   frame_pacer.SetTargetFrameRate(100.0);
+
+   const auto start =
+      Clock::now();
+
+   // the first frame starts right away, and every
+   // following frame starts a frame period later
+   for (int i { 0 }; i < 20; ++i)
+   {
+      frame_pacer.BeginFrame();
+      frame_pacer.EndFrame();
+   }
+
+   CHECK(Clock::now() - start >= std::chrono::milliseconds { 185 });
+   CHECK(frame_pacer.Frames() == 20);
+}
+
+// missed frame slots are dropped instead of rendering
+// the frames that follow back to back to catch up
+void TestMissedDeadline( )
+{
+   FramePacer frame_pacer;
+
+   frame_pacer.SetTargetFrameRate(100.0);
+
+   frame_pacer.BeginFrame();
+
+   std::this_thread::sleep_for(
+      std::chrono::milliseconds { 25 });
+
+   frame_pacer.EndFrame();
+
+   CHECK(frame_pacer.MissedDeadlines() == 1);
+   CHECK(frame_pacer.LastFrameCost() >= std::chrono::milliseconds { 25 });
+
+   const auto start =
+      Clock::now();
+
+   for (int i { 0 }; i < 5; ++i)
+   {
+      frame_pacer.BeginFrame();
+      frame_pacer.EndFrame();
+   }
+
+   CHECK(Clock::now() - start >= std::chrono::milliseconds { 30 });
+   CHECK(frame_pacer.Frames() == 6);
+}
+
+// a frame rendered late starts just ahead of its deadline
+void TestRenderLate( )
+{
+   FramePacer frame_pacer;
+
+   frame_pacer.SetRenderLate(true);
+   frame_pacer.SetTargetFrameRate(100.0);
+
+   const auto start =
+      Clock::now();
+
+   frame_pacer.BeginFrame();
+
+   CHECK(Clock::now() - start >= std::chrono::milliseconds { 8 });
+
+   frame_pacer.EndFrame();
+}
+
+// disabling the pacing while paced stops waiting for the deadlines
+void TestDisable( )
+{
+   FramePacer frame_pacer;
+
+   frame_pacer.SetTargetFrameRate(10.0);
+   frame_pacer.BeginFrame();
+   frame_pacer.EndFrame();
+   frame_pacer.SetTargetFrameRate(0.0);
+
+   const auto start =
+      Clock::now();
+
+   for (int i { 0 }; i < 10; ++i)
+   {
+      frame_pacer.BeginFrame();
+      frame_pacer.EndFrame();
+   }
+
+   CHECK(Clock::now() - start < std::chrono::milliseconds { 100 });
+}
+
+} // namespace
+
+int main( )
+{
+   TestUnpaced();
+   TestPaced();
+   TestMissedDeadline();
+   TestRenderLate();
+   TestDisable();
+
+   return
+      test::Result();
+}
@@ -0,0 +1,184 @@
+#include "test.h"
+
+#include "../mpsc-queue.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+constexpr size_t PRODUCERS { 4 };
+constexpr size_t VALUES_PER_PRODUCER { 100000 };
+
+struct Value
+{
+   size_t producer;
+   size_t sequence;
+};
+
+void TestSingleThreadOrder( )
+{
+   MPSCQueue< int > queue;
+
+   int value { -1 };
+
+   CHECK(!queue.Pop(value));
+   CHECK(queue.Size() == 0);
+
+   for (int i { 0 }; i < 10; ++i)
+   {
+      queue.Push(i);
+   }
+
+   CHECK(queue.Size() == 10);
+
+   for (int i { 0 }; i < 10; ++i)
+   {
+      CHECK(queue.Pop(value));
+      CHECK(value == i);
+   }
+
+   CHECK(!queue.Pop(value));
+   CHECK(queue.Size() == 0);
+}
+
+// the values of each producer are popped in the order they were
+// pushed, while the consumer pops concurrently with the producers
+void TestMultipleProducerOrder( )
+{
+   MPSCQueue< Value > queue;
+
+   std::atomic_bool start { false };
+   std::vector< std::thread > producers;
+
+   for (size_t producer { 0 }; producer < PRODUCERS; ++producer)
+   {
+      producers.emplace_back(
+         [ & queue, & start, producer ] ( )
+         {
+            while (!start)
+            {
+               std::this_thread::yield();
+            }
+
+            for (size_t sequence { 0 };
+                 sequence < VALUES_PER_PRODUCER;
+                 ++sequence)
+            {
+               queue.Push(
+                  Value { producer, sequence });
+            }
+         });
+   }
+
+   std::vector< size_t > next_sequences(
+      PRODUCERS,
+      0);
+   size_t popped { 0 };
+   size_t disordered { 0 };
+
+   start = true;
+
+   Value value { };
+
+   while (popped < PRODUCERS * VALUES_PER_PRODUCER)
+   {
+      if (queue.Pop(value))
+      {
+         if (value.producer >= PRODUCERS ||
+             value.sequence != next_sequences[value.producer])
+         {
+            ++disordered;
+         }
+         else
+         {
+            ++next_sequences[value.producer];
+         }
+
+         ++popped;
+      }
+      else
+      {
+         std::this_thread::yield();
+      }
+   }
+
+   for (auto & producer : producers)
+   {
+      producer.join();
+   }
+
+   CHECK(disordered == 0);
+   CHECK(!queue.Pop(value));
+   CHECK(queue.Size() == 0);
+
+   for (const auto next_sequence : next_sequences)
+   {
+      CHECK(next_sequence == VALUES_PER_PRODUCER);
+   }
+}
+
+// once the nodes are warmed up pushing and popping do not allocate
+void TestNodeRecycling( )
+{
+   MPSCQueue< int > queue;
+
+   int value { 0 };
+
+   for (int i { 0 }; i < 16; ++i)
+   {
+      queue.Push(i);
+   }
+
+   while (queue.Pop(value));
+
+   const auto allocations =
+      test::HeapAllocations();
+
+   for (int i { 0 }; i < 1000; ++i)
+   {
+      queue.Push(i);
+      queue.Push(i);
+
+      CHECK(queue.Pop(value));
+      CHECK(queue.Pop(value));
+   }
+
+   CHECK(test::HeapAllocations() == allocations);
+}
+
+void TestDestructionWithPendingValues( )
+{
+   const auto value =
+      std::make_shared< int >(0);
+
+   {
+      MPSCQueue< std::shared_ptr< int > > queue;
+
+      queue.Push(value);
+      queue.Push(value);
+
+      CHECK(value.use_count() == 3);
+   }
+
+   CHECK(value.use_count() == 1);
+}
+
+} // namespace
+
+int main( )
+{
+   TestSingleThreadOrder();
+   TestMultipleProducerOrder();
+   TestNodeRecycling();
+   TestDestructionWithPendingValues();
+
+   return
+      test::Result();
+}
@@ -0,0 +1,137 @@
+#include "test.h"
+
+#include "../multisample-governor.h"
+
+#include <chrono>
+#include <cstdint>
+
+namespace
+{
+
+using namespace std::chrono_literals;
+
+// adds the frames of a window and returns if the last one changed
+// the level.  none of the frames before the last may change it.
+bool AddWindow(
+   MultisampleGovernor & governor,
+   const MultisampleGovernor::Clock::duration frame_cost )
+{
+   for (uint32_t frame { 1 }; frame < governor.WindowFrames(); ++frame)
+   {
+      CHECK(!governor.AddFrameCost(frame_cost));
+   }
+
+   return
+      governor.AddFrameCost(
+         frame_cost);
+}
+
+void TestNoBudget( )
+{
+   MultisampleGovernor governor {
+      Multisample::FOUR,
+      0 };
+
+   CHECK(governor.Level() == Multisample::FOUR);
+   CHECK(governor.FrameBudget() == 0ms);
+
+   for (int window { 0 }; window < 4; ++window)
+   {
+      CHECK(!AddWindow(governor, 100ms));
+   }
+
+   CHECK(governor.Level() == Multisample::FOUR);
+}
+
+void TestStepDown( )
+{
+   MultisampleGovernor governor {
+      Multisample::FOUR,
+      0 };
+
+   governor.SetFrameBudget(10ms);
+
+   CHECK(AddWindow(governor, 20ms));
+   CHECK(governor.Level() == Multisample::TWO);
+   CHECK(governor.WindowFrameCost() == 20ms);
+
+   CHECK(AddWindow(governor, 20ms));
+   CHECK(governor.Level() == Multisample::NONE);
+
+   // there is no level below none
+   CHECK(!AddWindow(governor, 20ms));
+   CHECK(governor.Level() == Multisample::NONE);
+}
+
+// the frames following a change do not count towards a window
+void TestSettleFrames( )
+{
+   MultisampleGovernor governor {
+      Multisample::FOUR,
+      3 };
+
+   governor.SetFrameBudget(10ms);
+
+   CHECK(AddWindow(governor, 20ms));
+   CHECK(governor.Level() == Multisample::TWO);
+
+   for (int frame { 0 }; frame < 3; ++frame)
+   {
+      CHECK(!governor.AddFrameCost(100ms));
+   }
+
+   // a window within the budget without plenty of headroom
+   CHECK(!AddWindow(governor, 6ms));
+   CHECK(governor.Level() == Multisample::TWO);
+   CHECK(governor.WindowFrameCost() == 6ms);
+}
+
+// the level only steps up after several windows with plenty of
+// headroom in a row, and never above the maximum
+void TestStepUp( )
+{
+   MultisampleGovernor governor {
+      Multisample::FOUR,
+      0 };
+
+   governor.SetFrameBudget(10ms);
+
+   CHECK(AddWindow(governor, 20ms));
+   CHECK(governor.Level() == Multisample::TWO);
+
+   for (int window { 0 }; window < 7; ++window)
+   {
+      CHECK(!AddWindow(governor, 4ms));
+   }
+
+   // a window without plenty of headroom starts the count over
+   CHECK(!AddWindow(governor, 6ms));
+
+   for (int window { 0 }; window < 7; ++window)
+   {
+      CHECK(!AddWindow(governor, 4ms));
+   }
+
+   CHECK(AddWindow(governor, 4ms));
+   CHECK(governor.Level() == Multisample::FOUR);
+
+   for (int window { 0 }; window < 16; ++window)
+   {
+      CHECK(!AddWindow(governor, 1ms));
+   }
+
+   CHECK(governor.Level() == Multisample::FOUR);
+}
+
+} // namespace
+
+int main( )
+{
+   TestNoBudget();
+   TestStepDown();
+   TestSettleFrames();
+   TestStepUp();
+
+   return
+      test::Result();
+}
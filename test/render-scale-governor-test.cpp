@@ -0,0 +1,166 @@
+#include "test.h"
+
+#include "../render-scale-governor.h"
+
+#include <chrono>
+#include <cstdint>
+
+namespace
+{
+
+using namespace std::chrono_literals;
+
+// adds the frames of a window and returns if the last one changed
+// the scale.  none of the frames before the last may change it.
+bool AddWindow(
+   RenderScaleGovernor & governor,
+   const RenderScaleGovernor::Clock::duration frame_cost )
+{
+   for (uint32_t frame { 1 }; frame < governor.WindowFrames(); ++frame)
+   {
+      CHECK(!governor.AddFrameCost(frame_cost));
+   }
+
+   return
+      governor.AddFrameCost(
+         frame_cost);
+}
+
+// the default range fixes the scale at the full size
+void TestFixedScale( )
+{
+   RenderScaleGovernor governor {
+      0 };
+
+   governor.SetFrameBudget(10ms);
+
+   CHECK(governor.Scale() == 1.0);
+   CHECK(governor.AtMinimumScale());
+   CHECK(governor.AtMaximumScale());
+
+   CHECK(!AddWindow(governor, 40ms));
+   CHECK(governor.Scale() == 1.0);
+}
+
+void TestNoBudget( )
+{
+   RenderScaleGovernor governor {
+      0 };
+
+   governor.SetScaleRange(0.25, 1.0);
+
+   CHECK(!AddWindow(governor, 40ms));
+   CHECK(governor.Scale() == 1.0);
+}
+
+// the scale drops to the quantized estimate that meets the budget,
+// which scales the cost with the square of the scale
+void TestStepDown( )
+{
+   RenderScaleGovernor governor {
+      0 };
+
+   governor.SetScaleRange(0.25, 1.0);
+   governor.SetFrameBudget(10ms);
+
+   CHECK(governor.AtMaximumScale());
+
+   // frame costs that are not positive are ignored
+   CHECK(!governor.AddFrameCost(0ms));
+
+   CHECK(AddWindow(governor, 40ms));
+   CHECK(governor.Scale() == 0.4375);
+   CHECK(governor.WindowFrameCost() == 40ms);
+   CHECK(!governor.AtMinimumScale());
+   CHECK(!governor.AtMaximumScale());
+
+   CHECK(AddWindow(governor, 1000ms));
+   CHECK(governor.Scale() == 0.25);
+   CHECK(governor.AtMinimumScale());
+}
+
+// the scale rises to the lowest estimate of several windows in a
+// row that allow a higher scale
+void TestStepUp( )
+{
+   RenderScaleGovernor governor {
+      0 };
+
+   governor.SetScaleRange(0.25, 1.0);
+   governor.SetFrameBudget(10ms);
+
+   CHECK(AddWindow(governor, 40ms));
+   CHECK(governor.Scale() == 0.4375);
+
+   CHECK(!AddWindow(governor, 4ms));
+   CHECK(!AddWindow(governor, 4ms));
+   CHECK(!AddWindow(governor, 4ms));
+
+   // a window that keeps the scale starts the count over
+   CHECK(!AddWindow(governor, 8ms));
+
+   CHECK(!AddWindow(governor, 4ms));
+   CHECK(!AddWindow(governor, 5ms));
+   CHECK(!AddWindow(governor, 4ms));
+   CHECK(AddWindow(governor, 4ms));
+   CHECK(governor.Scale() == 0.5625);
+}
+
+// the frames following a change do not count towards a window
+void TestSettleFrames( )
+{
+   RenderScaleGovernor governor {
+      2 };
+
+   governor.SetScaleRange(0.25, 1.0);
+   governor.SetFrameBudget(10ms);
+
+   CHECK(AddWindow(governor, 40ms));
+   CHECK(governor.Scale() == 0.4375);
+
+   CHECK(!governor.AddFrameCost(1000ms));
+   CHECK(!governor.AddFrameCost(1000ms));
+
+   CHECK(!AddWindow(governor, 8ms));
+   CHECK(governor.Scale() == 0.4375);
+   CHECK(governor.WindowFrameCost() == 8ms);
+}
+
+// the scale is kept within a range set after it changed
+void TestScaleRange( )
+{
+   RenderScaleGovernor governor {
+      0 };
+
+   governor.SetScaleRange(0.25, 1.0);
+   governor.SetFrameBudget(10ms);
+
+   CHECK(AddWindow(governor, 1000ms));
+   CHECK(governor.Scale() == 0.25);
+
+   governor.SetScaleRange(0.5, 0.75);
+
+   CHECK(governor.Scale() == 0.5);
+   CHECK(governor.AtMinimumScale());
+
+   // scales outside of what can be rendered are clamped
+   governor.SetScaleRange(0.0, 2.0);
+
+   CHECK(governor.Scale() == 0.25);
+   CHECK(!governor.AtMaximumScale());
+}
+
+} // namespace
+
+int main( )
+{
+   TestFixedScale();
+   TestNoBudget();
+   TestStepDown();
+   TestStepUp();
+   TestSettleFrames();
+   TestScaleRange();
+
+   return
+      test::Result();
+}
@@ -0,0 +1,271 @@
+#include "test.h"
+
+#include "../render-task.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace
+{
+
+// counts the instances alive, so destruction can be checked
+struct Instances
+{
+   Instances( int & count ) noexcept : count_ { &count } { ++*count_; }
+   Instances( const Instances & o ) noexcept : count_ { o.count_ } { ++*count_; }
+   Instances( Instances && o ) noexcept : count_ { o.count_ } { ++*count_; }
+   ~Instances( ) noexcept { --*count_; }
+
+   Instances & operator = ( const Instances & ) noexcept = delete;
+   Instances & operator = ( Instances && ) noexcept = delete;
+
+   int * count_;
+};
+
+// a callable larger than the small buffer
+struct LargeCallable
+{
+   void operator ( ) ( ) noexcept
+   {
+      ++*calls;
+   }
+
+   int * calls;
+   std::array< char, 256 > payload;
+};
+
+// a callable that may throw when moved cannot be stored in place
+struct ThrowingMoveCallable
+{
+   ThrowingMoveCallable( int & calls ) noexcept : calls_ { &calls } { }
+   ThrowingMoveCallable( ThrowingMoveCallable && o ) noexcept(false) :
+      calls_ { o.calls_ } { }
+
+   void operator ( ) ( ) noexcept
+   {
+      ++*calls_;
+   }
+
+   int * calls_;
+};
+
+void TestEmptyTask( )
+{
+   RenderTask task;
+
+   CHECK(!task.Valid());
+
+   // invoking an empty task does nothing
+   task();
+}
+
+void TestLocalStorage( )
+{
+   int calls { 0 };
+   std::array< double, 9 > camera { };
+
+   const auto allocations =
+      test::HeapAllocations();
+
+   RenderTask task {
+      [ & calls, camera ] ( )
+      {
+         calls += static_cast< int >(camera[0]) + 1;
+      } };
+
+   CHECK(test::HeapAllocations() == allocations);
+   CHECK(task.Valid());
+
+   task();
+   task();
+
+   CHECK(calls == 2);
+}
+
+void TestHeapFallback( )
+{
+   int calls { 0 };
+
+   {
+      const auto allocations =
+         test::HeapAllocations();
+
+      RenderTask task {
+         LargeCallable { &calls, { } } };
+
+      CHECK(test::HeapAllocations() == allocations + 1);
+
+      task();
+
+      CHECK(calls == 1);
+
+      // moving a heap stored task moves the pointer only
+      const auto move_allocations =
+         test::HeapAllocations();
+
+      RenderTask moved {
+         std::move(task) };
+
+      CHECK(test::HeapAllocations() == move_allocations);
+      CHECK(!task.Valid());
+
+      moved();
+
+      CHECK(calls == 2);
+   }
+
+   {
+      const auto allocations =
+         test::HeapAllocations();
+
+      RenderTask task {
+         ThrowingMoveCallable { calls } };
+
+      CHECK(test::HeapAllocations() == allocations + 1);
+
+      task();
+
+      CHECK(calls == 3);
+   }
+}
+
+void TestMove( )
+{
+   int instances { 0 };
+   int calls { 0 };
+
+   {
+      RenderTask task {
+         [ & calls, counted = Instances { instances } ] ( )
+         {
+            ++calls;
+         } };
+
+      CHECK(instances == 1);
+
+      RenderTask moved {
+         std::move(task) };
+
+      // the callable is moved out of the source, not copied
+      CHECK(instances == 1);
+      CHECK(!task.Valid());
+      CHECK(moved.Valid());
+
+      moved();
+
+      CHECK(calls == 1);
+
+      RenderTask assigned {
+         [ & calls, counted = Instances { instances } ] ( )
+         {
+            calls += 10;
+         } };
+
+      CHECK(instances == 2);
+
+      // assigning destroys the callable held before
+      assigned = std::move(moved);
+
+      CHECK(instances == 1);
+      CHECK(!moved.Valid());
+
+      assigned();
+
+      CHECK(calls == 2);
+
+      assigned = std::move(assigned);
+
+      CHECK(assigned.Valid());
+      CHECK(instances == 1);
+   }
+
+   CHECK(instances == 0);
+
+   {
+      RenderTask task {
+         LargeCallable { &calls, { } } };
+      RenderTask assigned {
+         [ counted = Instances { instances } ] ( ) { } };
+
+      assigned = std::move(task);
+
+      CHECK(instances == 0);
+
+      assigned();
+
+      CHECK(calls == 3);
+   }
+}
+
+void TestCompletion( )
+{
+   std::future< void > completed;
+
+   auto completion =
+      RenderTaskCompletion::Create(
+         completed);
+
+   CHECK(completion.Valid());
+   CHECK(completed.valid());
+   CHECK(
+      completed.wait_for(std::chrono::seconds::zero()) ==
+      std::future_status::timeout);
+
+   RenderTaskCompletion moved {
+      std::move(completion) };
+
+   CHECK(!completion.Valid());
+
+   std::thread completer {
+      [ & moved ] ( )
+      {
+         moved.Complete();
+      } };
+
+   completed.get();
+   completer.join();
+
+   CHECK(!moved.Valid());
+
+   // the future of a completion released without
+   // completing it reports the broken promise
+   {
+      auto abandoned =
+         RenderTaskCompletion::Create(
+            completed);
+   }
+
+   bool broken_promise { false };
+
+   try
+   {
+      completed.get();
+   }
+   catch (const std::future_error & error)
+   {
+      broken_promise =
+         error.code() == std::future_errc::broken_promise;
+   }
+
+   CHECK(broken_promise);
+}
+
+} // namespace
+
+int main( )
+{
+   TestEmptyTask();
+   TestLocalStorage();
+   TestHeapFallback();
+   TestMove();
+   TestCompletion();
+
+   return
+      test::Result();
+}
@@ -0,0 +1,206 @@
+#include "test.h"
+
+#include "../swap-chain.h"
+
+#include <osg/FrameBufferObject>
+
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using namespace std::chrono_literals;
+
+// frame buffers are never bound, so no context is needed
+struct CreateFrameBuffer
+{
+   SwapChain::FrameBuffer operator ( ) ( )
+   {
+      ++*created;
+
+      ColorBuffer color_buffer;
+      color_buffer.texture_id = *created;
+
+      return {
+         color_buffer,
+         new osg::FrameBufferObject };
+   }
+
+   size_t * created;
+};
+
+void TestFill( )
+{
+   size_t created { 0 };
+
+   SwapChain swap_chain {
+      CreateFrameBuffer { &created },
+      2,
+      4 };
+
+   CHECK(swap_chain.MinimumDepth() == 2);
+   CHECK(swap_chain.Statistics().depth == 0);
+
+   swap_chain.Fill();
+
+   CHECK(created == 2);
+   CHECK(swap_chain.Statistics().depth == 2);
+
+   swap_chain.Fill();
+
+   CHECK(created == 2);
+}
+
+// the chain only grows when the consumer holds on to every buffer
+// for longer than the hold threshold, and skips the frame otherwise
+void TestGrow( )
+{
+   size_t created { 0 };
+
+   SwapChain swap_chain {
+      CreateFrameBuffer { &created },
+      2,
+      3 };
+
+   swap_chain.Fill();
+
+   const auto first =
+      swap_chain.Acquire();
+   const auto second =
+      swap_chain.Acquire();
+
+   CHECK(first.second);
+   CHECK(second.second);
+   CHECK(!(first.first == second.first));
+   CHECK(swap_chain.Statistics().depth == 2);
+   CHECK(swap_chain.Statistics().occupancy == 2);
+   CHECK(swap_chain.Statistics().grown == 0);
+
+   CHECK(!swap_chain.Acquire().second);
+   CHECK(swap_chain.Statistics().skipped_frames == 1);
+
+   std::this_thread::sleep_for(60ms);
+
+   const auto third =
+      swap_chain.Acquire();
+
+   CHECK(third.second);
+   CHECK(swap_chain.Statistics().depth == 3);
+   CHECK(swap_chain.Statistics().grown == 1);
+
+   // the chain does not grow beyond its maximum depth
+   CHECK(!swap_chain.Acquire().second);
+   CHECK(swap_chain.Statistics().depth == 3);
+   CHECK(swap_chain.Statistics().skipped_frames == 2);
+
+   swap_chain.Release(first.first);
+   swap_chain.Release(first.first);
+
+   CHECK(swap_chain.Statistics().occupancy == 2);
+
+   const auto fourth =
+      swap_chain.Acquire();
+
+   CHECK(fourth.first == first.first);
+   CHECK(fourth.second == first.second);
+
+   swap_chain.Release(second.first);
+   swap_chain.Release(third.first);
+   swap_chain.Release(fourth.first);
+
+   CHECK(swap_chain.Statistics().occupancy == 0);
+}
+
+// a chain that always had a buffer to spare over the idle period
+// gives one back, which takes the length of the idle period
+void TestShrink( )
+{
+   size_t created { 0 };
+
+   SwapChain swap_chain {
+      CreateFrameBuffer { &created },
+      3,
+      3 };
+
+   swap_chain.Fill();
+   swap_chain.SetDepth(1, 3);
+
+   CHECK(swap_chain.MinimumDepth() == 1);
+
+   swap_chain.Release(swap_chain.Acquire().first);
+
+   CHECK(swap_chain.Statistics().depth == 3);
+
+   std::this_thread::sleep_for(5100ms);
+
+   const auto frame_buffer =
+      swap_chain.Acquire();
+
+   CHECK(frame_buffer.second);
+   CHECK(swap_chain.Statistics().depth == 2);
+   CHECK(swap_chain.Statistics().shrunk == 1);
+
+   swap_chain.Release(frame_buffer.first);
+}
+
+// retired buffers held by the consumer are freed once released and
+// the chain allocates new buffers in place of the retired ones
+void TestRetire( )
+{
+   size_t created { 0 };
+
+   SwapChain swap_chain {
+      CreateFrameBuffer { &created },
+      2,
+      2 };
+
+   swap_chain.Fill();
+
+   const auto held =
+      swap_chain.Acquire();
+
+   swap_chain.Retire();
+
+   CHECK(swap_chain.Statistics().depth == 0);
+   CHECK(swap_chain.Statistics().occupancy == 1);
+   // the retired buffer and the consumer
+   CHECK(held.second->referenceCount() == 2);
+
+   const auto acquired =
+      swap_chain.Acquire();
+
+   CHECK(acquired.second);
+   CHECK(!(acquired.first == held.first));
+   CHECK(created == 3);
+   CHECK(swap_chain.Statistics().depth == 1);
+   CHECK(swap_chain.Statistics().occupancy == 2);
+
+   swap_chain.Fill();
+
+   CHECK(swap_chain.Statistics().depth == 2);
+
+   swap_chain.Release(held.first);
+
+   CHECK(swap_chain.Statistics().occupancy == 1);
+   CHECK(held.second->referenceCount() == 1);
+
+   swap_chain.Release(acquired.first);
+
+   CHECK(swap_chain.Statistics().occupancy == 0);
+}
+
+} // namespace
+
+int main( )
+{
+   TestFill();
+   TestGrow();
+   TestRetire();
+   TestShrink();
+
+   return
+      test::Result();
+}
@@ -0,0 +1,93 @@
+#ifndef _TEST_H_
+#define _TEST_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+// every test is a single translation unit, so the replacement of the
+// global operator new that counts heap allocations is defined here
+static std::atomic< uint64_t > heap_allocations_ { 0 };
+
+void * operator new(
+   std::size_t size )
+{
+   heap_allocations_.fetch_add(
+      1,
+      std::memory_order_relaxed);
+
+   if (const auto memory = std::malloc(size ? size : 1))
+   {
+      return memory;
+   }
+
+   throw std::bad_alloc { };
+}
+
+void operator delete(
+   void * memory ) noexcept
+{
+   std::free(memory);
+}
+
+void operator delete(
+   void * memory,
+   std::size_t ) noexcept
+{
+   std::free(memory);
+}
+
+namespace test
+{
+
+inline uint64_t HeapAllocations( ) noexcept
+{
+   return
+      heap_allocations_.load(
+         std::memory_order_relaxed);
+}
+
+inline std::atomic< uint32_t > & Failures( ) noexcept
+{
+   static std::atomic< uint32_t > failures { 0 };
+
+   return failures;
+}
+
+inline void Check(
+   const bool passed,
+   const char * const condition,
+   const char * const file,
+   const int line ) noexcept
+{
+   if (!passed)
+   {
+      ++Failures();
+
+      std::cerr
+         << file
+         << "("
+         << line
+         << "): check failed: "
+         << condition
+         << std::endl;
+   }
+}
+
+// the exit code of the test
+inline int Result( ) noexcept
+{
+   return
+      Failures() ?
+      EXIT_FAILURE :
+      EXIT_SUCCESS;
+}
+
+} // namespace test
+
+#define CHECK( condition ) \
+   test::Check(static_cast< bool >(condition), #condition, __FILE__, __LINE__)
+
+#endif // _TEST_H_
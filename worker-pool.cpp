@@ -0,0 +1,278 @@
+#include "worker-pool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace worker_pool
+{
+
+struct Job
+{
+   std::function< void ( const size_t ) > task;
+   size_t count;
+
+   std::atomic< size_t > next { 0 };
+   std::atomic< size_t > completed { 0 };
+
+   std::mutex completed_mutex;
+   std::condition_variable completed_condition;
+};
+
+static std::vector< std::thread > worker_threads_;
+static std::mutex worker_threads_mutex_;
+
+static std::deque< std::shared_ptr< Job > > jobs_;
+static std::mutex jobs_mutex_;
+static std::condition_variable jobs_condition_;
+static bool quit_worker_threads_ { false };
+
+static std::atomic< size_t > worker_thread_count_ { 0 };
+
+static void ExecuteTasks(
+   Job & job )
+{
+   size_t executed { 0 };
+
+   for (auto index = job.next.fetch_add(1);
+        index < job.count;
+        index = job.next.fetch_add(1))
+   {
+      job.task(index);
+
+      ++executed;
+   }
+
+   if (executed &&
+       job.completed.fetch_add(executed) + executed == job.count)
+   {
+      {
+#if _has_cxx_class_template_argument_deduction
+         std::lock_guard lock {
+            job.completed_mutex };
+#else
+         std::lock_guard< decltype(job.completed_mutex) > lock {
+            job.completed_mutex };
+#endif
+      }
+
+      job.completed_condition.notify_all();
+   }
+}
+
+static void WorkerLoop( )
+{
+   while (true)
+   {
+      std::shared_ptr< Job > job;
+
+      {
+         std::unique_lock< std::mutex > lock {
+            jobs_mutex_ };
+
+         jobs_condition_.wait(
+            lock,
+            [ ] ( )
+            {
+               return
+                  quit_worker_threads_ ||
+                  !jobs_.empty();
+            });
+
+         if (jobs_.empty())
+         {
+            break;
+         }
+
+         job = jobs_.front();
+
+         // jobs stay queued until all of their tasks are handed out
+         if (job->next >= job->count)
+         {
+            jobs_.pop_front();
+
+            continue;
+         }
+      }
+
+      ExecuteTasks(
+         *job);
+   }
+}
+
+void Start(
+   const size_t worker_thread_count ) noexcept
+{
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      worker_threads_mutex_ };
+#else
+   std::lock_guard< decltype(worker_threads_mutex_) > lock {
+      worker_threads_mutex_ };
+#endif
+
+   if (worker_threads_.empty())
+   {
+      quit_worker_threads_ = false;
+
+      for (size_t i { 0 }; i < worker_thread_count; ++i)
+      {
+         worker_threads_.emplace_back(
+            &WorkerLoop);
+      }
+
+      worker_thread_count_ =
+         worker_threads_.size();
+   }
+}
+
+void Stop( ) noexcept
+{
+#if _has_cxx_class_template_argument_deduction
+   std::lock_guard lock {
+      worker_threads_mutex_ };
+#else
+   std::lock_guard< decltype(worker_threads_mutex_) > lock {
+      worker_threads_mutex_ };
+#endif
+
+   if (!worker_threads_.empty())
+   {
+      {
+#if _has_cxx_class_template_argument_deduction
+         std::lock_guard jobs_lock {
+            jobs_mutex_ };
+#else
+         std::lock_guard< decltype(jobs_mutex_) > jobs_lock {
+            jobs_mutex_ };
+#endif
+
+         quit_worker_threads_ = true;
+      }
+
+      jobs_condition_.notify_all();
+
+      for (auto & worker_thread : worker_threads_)
+      {
+         worker_thread.join();
+      }
+
+      worker_threads_.clear();
+
+      worker_thread_count_ = 0;
+   }
+}
+
+size_t WorkerThreadCount( ) noexcept
+{
+   return worker_thread_count_;
+}
+
+void ParallelFor(
+   const size_t count,
+   const std::function< void ( const size_t ) > & task ) noexcept
+{
+   if (count <= 1 || !worker_thread_count_)
+   {
+      for (size_t index { 0 }; index < count; ++index)
+      {
+         task(index);
+      }
+   }
+   else
+   {
+      Wait(
+         Dispatch(
+            count,
+            task));
+   }
+}
+
+JobHandle Dispatch(
+   const size_t count,
+   std::function< void ( const size_t ) > task ) noexcept
+{
+   const auto job =
+      std::make_shared< Job >();
+
+   job->task = std::move(task);
+   job->count = count;
+
+   const size_t worker_thread_count {
+      worker_thread_count_ };
+
+   if (count && worker_thread_count)
+   {
+      {
+#if _has_cxx_class_template_argument_deduction
+         std::lock_guard lock {
+            jobs_mutex_ };
+#else
+         std::lock_guard< decltype(jobs_mutex_) > lock {
+            jobs_mutex_ };
+#endif
+
+         jobs_.emplace_back(
+            job);
+      }
+
+      for (size_t i { 0 };
+           i < count && i < worker_thread_count;
+           ++i)
+      {
+         jobs_condition_.notify_one();
+      }
+   }
+
+   return job;
+}
+
+void Wait(
+   const JobHandle & job ) noexcept
+{
+   if (job)
+   {
+      ExecuteTasks(
+         *job);
+
+      {
+         std::unique_lock< std::mutex > lock {
+            job->completed_mutex };
+
+         job->completed_condition.wait(
+            lock,
+            [ & job ] ( )
+            {
+               return job->completed == job->count;
+            });
+      }
+
+#if _has_cxx_class_template_argument_deduction
+      std::lock_guard lock {
+         jobs_mutex_ };
+#else
+      std::lock_guard< decltype(jobs_mutex_) > lock {
+         jobs_mutex_ };
+#endif
+
+      // the workers may not have taken the job off the queue yet
+      for (auto queued_job = jobs_.begin();
+           queued_job != jobs_.end();
+           ++queued_job)
+      {
+         if (*queued_job == job)
+         {
+            jobs_.erase(
+               queued_job);
+
+            break;
+         }
+      }
+   }
+}
+
+} // namespace worker_pool
@@ -0,0 +1,40 @@
+#ifndef _WORKER_POOL_H_
+#define _WORKER_POOL_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace worker_pool
+{
+
+// worker threads for cpu only work that does not need a gl context
+void Start(
+   const size_t worker_thread_count ) noexcept;
+void Stop( ) noexcept;
+
+size_t WorkerThreadCount( ) noexcept;
+
+struct Job;
+using JobHandle = std::shared_ptr< Job >;
+
+// invokes the task once for every index in [0, count) and returns
+// after all of them completed.  the calling thread executes tasks as
+// well, so the tasks run inline when the pool has not been started.
+void ParallelFor(
+   const size_t count,
+   const std::function< void ( const size_t ) > & task ) noexcept;
+
+// same as parallel for, but returns right after queuing the tasks,
+// so the calling thread can do other work in the meantime.  wait
+// executes the tasks no worker has taken yet and must be called
+// before anything the task refers to goes out of scope.
+JobHandle Dispatch(
+   const size_t count,
+   std::function< void ( const size_t ) > task ) noexcept;
+void Wait(
+   const JobHandle & job ) noexcept;
+
+} // namespace worker_pool
+
+#endif // _WORKER_POOL_H_